@@ -0,0 +1,285 @@
+#include "absorption.h"
+#include <math.h>
+
+AbsorptionOptions absorption_default_options(void) {
+    AbsorptionOptions opt;
+    opt.tol = 1e-10;
+    opt.max_sweeps = 10000;
+    return opt;
+}
+
+
+// ---------- Blocs d’états transitoires ----------
+typedef struct {
+    int *class_of;   // classe de chaque sommet
+    int *states;     // états transitoires, classe après classe
+    int *start;      // nblocks+1 débuts de bloc dans states
+    int  nblocks;
+} TransientBlocks;
+
+static TransientBlocks transient_blocks(const CsrGraph *G, const TarjanPartition *P,
+                                        const Classification *K) {
+    TransientBlocks T;
+    T.class_of = build_vertex_to_class(P, G->n);
+    T.states = (int*)malloc(((size_t)G->n + 1) * sizeof(int));
+    T.start = (int*)malloc(((size_t)P->size + 1) * sizeof(int));
+    if (!T.states || !T.start) {
+        perror("malloc transient blocks");
+        exit(EXIT_FAILURE);
+    }
+
+    int ordered = 1;
+    int count = 0;
+    T.nblocks = 0;
+    for (int c = 0; c < P->size; ++c) {
+        if (K->persistent[c]) continue;
+        T.start[T.nblocks++] = count;
+        for (int k = 0; k < P->classes[c].size; ++k) {
+            int u = P->classes[c].members[k];
+            T.states[count++] = u;
+            // un arc vers une classe plus loin dans P casse l’ordre puits d’abord
+            for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+                if (T.class_of[G->dest[e]] > c) ordered = 0;
+        }
+    }
+    T.start[T.nblocks] = count;
+
+    if (!ordered && T.nblocks > 1) {
+        T.start[1] = count;
+        T.nblocks = 1;
+    }
+    return T;
+}
+
+static void transient_blocks_free(TransientBlocks *T) {
+    free(T->class_of);
+    free(T->states);
+    free(T->start);
+}
+
+/*
+   Gauss-Seidel bloc par bloc sur x = b + Q x. x vaut 0 hors des
+   transitoires : les arcs vers les classes fermées ne contribuent que
+   par b. Les blocs précédents sont déjà résolus.
+*/
+static AbsorptionReport solve_blocks(const CsrGraph *G, const TransientBlocks *T,
+                                     const double *b, const AbsorptionOptions *opt, double *x) {
+    AbsorptionReport R = { 1, T->nblocks, 0, 0.0 };
+
+    for (int k = 0; k < T->nblocks; ++k) {
+        int first = T->start[k], last = T->start[k + 1];
+        int single = (last - first == 1);
+        double change = 0.0;
+        int sweeps = 0;
+
+        while (sweeps < opt->max_sweeps) {
+            double scale = 1.0;
+            change = 0.0;
+            for (int s = first; s < last; ++s) {
+                int u = T->states[s];
+                double acc = b[u], diag = 0.0;
+                for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e) {
+                    int v = G->dest[e];
+                    if (v == u) diag += G->prob[e];
+                    else acc += G->prob[e] * x[v];
+                }
+                double nx = acc / (1.0 - diag);
+                double d = fabs(nx - x[u]);
+                if (d > change) change = d;
+                if (fabs(nx) > scale) scale = fabs(nx);
+                x[u] = nx;
+            }
+            sweeps++;
+            change /= scale;
+            // un état seul est résolu exactement en une passe
+            if (single || change < opt->tol) break;
+        }
+
+        R.sweeps += sweeps;
+        if (!(change < opt->tol) && !single) R.converged = 0;
+        if (!(change <= R.residual)) R.residual = change;   // NaN compris
+    }
+    return R;
+}
+
+AbsorptionReport absorption_probabilities(const CsrGraph *G, const TarjanPartition *P,
+                                          const Classification *K, int target,
+                                          const AbsorptionOptions *opt, double *h) {
+    if (target < 0 || target >= P->size || !K->persistent[target]) {
+        fprintf(stderr, "absorption_probabilities : la classe %d n est pas fermee\n", target);
+        exit(EXIT_FAILURE);
+    }
+    AbsorptionOptions def = absorption_default_options();
+    if (!opt) opt = &def;
+    for (int v = 0; v <= G->n; ++v) h[v] = 0.0;
+
+    TransientBlocks T = transient_blocks(G, P, K);
+    double *b = (double*)calloc((size_t)G->n + 1, sizeof(double));
+    if (!b) {
+        perror("malloc absorption rhs");
+        exit(EXIT_FAILURE);
+    }
+
+    // b(u) = masse qui part de u directement dans la classe visée
+    int nt = T.start[T.nblocks];
+    for (int s = 0; s < nt; ++s) {
+        int u = T.states[s];
+        for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+            if (T.class_of[G->dest[e]] == target) b[u] += G->prob[e];
+    }
+
+    AbsorptionReport R = solve_blocks(G, &T, b, opt, h);
+    for (int k = 0; k < P->classes[target].size; ++k) h[P->classes[target].members[k]] = 1.0;
+
+    free(b);
+    transient_blocks_free(&T);
+    return R;
+}
+
+AbsorptionReport expected_steps(const CsrGraph *G, const TarjanPartition *P,
+                                const Classification *K, const AbsorptionOptions *opt,
+                                double *t) {
+    AbsorptionOptions def = absorption_default_options();
+    if (!opt) opt = &def;
+    for (int v = 0; v <= G->n; ++v) t[v] = 0.0;
+
+    TransientBlocks T = transient_blocks(G, P, K);
+    double *b = (double*)calloc((size_t)G->n + 1, sizeof(double));
+    if (!b) {
+        perror("malloc absorption rhs");
+        exit(EXIT_FAILURE);
+    }
+    int nt = T.start[T.nblocks];
+    for (int s = 0; s < nt; ++s) b[T.states[s]] = 1.0;
+
+    AbsorptionReport R = solve_blocks(G, &T, b, opt, t);
+
+    free(b);
+    transient_blocks_free(&T);
+    return R;
+}
+
+
+// ---------- Version dense ----------
+Absorption absorption_dense(const Matrix *M, const TarjanPartition *P, const Classification *K) {
+    Absorption A;
+    int n = M->n;
+    int *class_of = build_vertex_to_class(P, n);
+
+    A.ok = 1;
+    A.ntransient = 0;
+    A.nclosed = K->persistent_count;
+    A.transient = (int*)malloc(((size_t)n > 0 ? n : 1) * sizeof(int));
+    A.closed = (int*)malloc((A.nclosed > 0 ? A.nclosed : 1) * sizeof(int));
+    int *rank = (int*)malloc((P->size > 0 ? P->size : 1) * sizeof(int));
+    if (!A.transient || !A.closed || !rank) {
+        perror("malloc absorption");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0, r = 0; c < P->size; ++c) {
+        rank[c] = K->persistent[c] ? r : -1;
+        if (K->persistent[c]) A.closed[r++] = c;
+    }
+    for (int v = 1; v <= n; ++v)
+        if (class_of[v] >= 0 && !K->persistent[class_of[v]]) A.transient[A.ntransient++] = v;
+
+    // système augmenté [I - Q | R | 1], ligne par ligne
+    int t = A.ntransient;
+    int w = t + A.nclosed + 1;
+    double *S = (double*)calloc((size_t)t * w + 1, sizeof(double));
+    A.absorb = (double*)calloc((size_t)t * A.nclosed + 1, sizeof(double));
+    A.steps = (double*)calloc((size_t)t + 1, sizeof(double));
+    if (!S || !A.absorb || !A.steps) {
+        perror("malloc absorption system");
+        exit(EXIT_FAILURE);
+    }
+
+    Matrix Q = subMatrixStates(M, A.transient, t);
+    for (int i = 0; i < t; ++i) {
+        double *row = S + (size_t)i * w;
+        for (int j = 0; j < t; ++j) row[j] = (i == j) - (double)MAT(&Q, i, j);
+        for (int v = 1; v <= n; ++v) {
+            int r = class_of[v] >= 0 ? rank[class_of[v]] : -1;
+            if (r >= 0) row[t + r] += MAT(M, A.transient[i] - 1, v - 1);
+        }
+        row[w - 1] = 1.0;
+    }
+    matrix_free(&Q);
+
+    // élimination avec pivot partiel
+    for (int k = 0; k < t && A.ok; ++k) {
+        int p = k;
+        for (int i = k + 1; i < t; ++i)
+            if (fabs(S[(size_t)i * w + k]) > fabs(S[(size_t)p * w + k])) p = i;
+        if (fabs(S[(size_t)p * w + k]) < 1e-12) {
+            A.ok = 0;
+            break;
+        }
+        if (p != k)
+            for (int j = k; j < w; ++j) {
+                double x = S[(size_t)k * w + j];
+                S[(size_t)k * w + j] = S[(size_t)p * w + j];
+                S[(size_t)p * w + j] = x;
+            }
+        double *pk = S + (size_t)k * w;
+        for (int i = k + 1; i < t; ++i) {
+            double *ri = S + (size_t)i * w;
+            double f = ri[k] / pk[k];
+            if (f == 0.0) continue;
+            for (int j = k; j < w; ++j) ri[j] -= f * pk[j];
+        }
+    }
+
+    // remontée sur tous les seconds membres
+    if (A.ok) {
+        for (int i = t - 1; i >= 0; --i) {
+            double *ri = S + (size_t)i * w;
+            for (int j = t; j < w; ++j) {
+                double x = ri[j];
+                for (int k = i + 1; k < t; ++k) x -= ri[k] * S[(size_t)k * w + j];
+                ri[j] = x / ri[i];
+            }
+        }
+        for (int i = 0; i < t; ++i) {
+            const double *ri = S + (size_t)i * w;
+            for (int r = 0; r < A.nclosed; ++r) A.absorb[(size_t)i * A.nclosed + r] = ri[t + r];
+            A.steps[i] = ri[w - 1];
+        }
+    }
+
+    free(S);
+    free(rank);
+    free(class_of);
+    return A;
+}
+
+void absorption_print(const TarjanPartition *P, const Absorption *A) {
+    if (!A->ok) {
+        printf("Systeme singulier : I - Q n est pas inversible.\n");
+        return;
+    }
+    if (A->ntransient == 0) {
+        printf("Aucun etat transitoire.\n");
+        return;
+    }
+    for (int i = 0; i < A->ntransient; ++i) {
+        printf("Etat %d :", A->transient[i]);
+        for (int r = 0; r < A->nclosed; ++r) {
+            double h = A->absorb[(size_t)i * A->nclosed + r];
+            if (h == 0.0) h = 0.0;   // pas de "-0.0000"
+            printf(" %s %.4f", P->classes[A->closed[r]].name, h);
+        }
+        printf("  (%.2f pas en moyenne)\n", A->steps[i]);
+    }
+}
+
+void absorption_free(Absorption *A) {
+    if (!A) return;
+    free(A->transient);
+    free(A->closed);
+    free(A->absorb);
+    free(A->steps);
+    A->transient = A->closed = NULL;
+    A->absorb = A->steps = NULL;
+    A->ntransient = A->nclosed = 0;
+}
@@ -0,0 +1,73 @@
+#ifndef ABSORPTION_H
+#define ABSORPTION_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+#include "caracteristiques.h"
+
+/*
+   Absorption dans les classes persistantes.
+
+   Avec Q la restriction de M aux états transitoires et R_c la masse qui
+   part de chaque transitoire vers la classe fermée c :
+     - probabilité d’absorption dans c : h = (I - Q)^-1 R_c
+     - nombre moyen de pas avant absorption : t = (I - Q)^-1 1
+   On résout ces systèmes directement au lieu d’élever M à une grande
+   puissance. Les lignes ne sont pas renormalisées : on résout les systèmes
+   de la matrice telle qu’elle a été lue.
+*/
+
+// Paramètres de Gauss-Seidel (version creuse)
+typedef struct {
+    double tol;         // arrêt quand la plus grande correction < tol (relative)
+    int    max_sweeps;  // balayages maximaux par bloc
+} AbsorptionOptions;
+
+// tol = 1e-10, max_sweeps = 10000
+AbsorptionOptions absorption_default_options(void);
+
+typedef struct {
+    int    converged;   // 1 si tous les blocs ont atteint la tolérance
+    int    blocks;      // blocs résolus l’un après l’autre
+    int    sweeps;      // balayages, tous blocs confondus
+    double residual;    // plus grande dernière correction (relative)
+} AbsorptionReport;
+
+/*
+   Version creuse, sur les arcs CSR. Les états transitoires sont traités
+   classe par classe dans l’ordre de P : Tarjan rend les classes puits
+   d’abord, donc chaque classe ne dépend que de classes déjà résolues et
+   Gauss-Seidel ne tourne que sur un bloc à la fois (une seule passe pour
+   une classe réduite à un état). Si P n’est pas dans cet ordre, tous les
+   transitoires forment un seul bloc.
+   h (taille n+1) reçoit la probabilité d’absorption dans la classe fermée
+   target depuis chaque sommet (1 dans target, 0 dans les autres classes
+   fermées) ; target doit être une classe persistante de P (K->persistent),
+   sinon le programme s’arrête ; t (taille n+1) le nombre moyen de pas (0 hors transitoires).
+*/
+AbsorptionReport absorption_probabilities(const CsrGraph *G, const TarjanPartition *P,
+                                          const Classification *K, int target,
+                                          const AbsorptionOptions *opt, double *h);
+AbsorptionReport expected_steps(const CsrGraph *G, const TarjanPartition *P,
+                                const Classification *K, const AbsorptionOptions *opt,
+                                double *t);
+
+// Version dense : sous-matrice des transitoires (subMatrixStates), puis
+// élimination de Gauss avec pivot partiel sur [I - Q | R | 1], tous les
+// seconds membres à la fois. Pour les petites chaînes.
+typedef struct {
+    int     ok;          // 0 : I - Q singulière
+    int     ntransient;
+    int     nclosed;
+    int    *transient;   // états transitoires, croissants
+    int    *closed;      // indices des classes fermées
+    double *absorb;      // ntransient × nclosed, ligne i : depuis transient[i]
+    double *steps;       // ntransient
+} Absorption;
+
+Absorption absorption_dense(const Matrix *M, const TarjanPartition *P, const Classification *K);
+void       absorption_print(const TarjanPartition *P, const Absorption *A);
+void       absorption_free(Absorption *A);
+
+#endif // ABSORPTION_H
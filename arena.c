@@ -0,0 +1,76 @@
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_DEFAULT_BLOCK ((size_t)64 << 10)
+
+// Taille arrondie au multiple de ARENA_ALIGN supérieur
+static size_t arena_round(size_t x) {
+    return (x + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+// Début des données d’un bloc (juste après l’en-tête arrondi)
+static char *block_data(ArenaBlock *B) {
+    return (char*)B + arena_round(sizeof(ArenaBlock));
+}
+
+Arena arena_create(size_t block_size) {
+    Arena A;
+    A.head = NULL;
+    A.block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK;
+    A.nblocks = 0;
+    A.nallocs = 0;
+    A.bytes = 0;
+    return A;
+}
+
+void *arena_alloc(Arena *A, size_t bytes) {
+    bytes = arena_round(bytes > 0 ? bytes : 1);
+    ArenaBlock *B = A->head;
+    if (!B || B->size - B->used < bytes) {
+        // nouveau bloc : taille par défaut, ou plus si l’objet ne tient pas
+        size_t size = bytes > A->block_size ? bytes : A->block_size;
+        B = (ArenaBlock*)malloc(arena_round(sizeof(ArenaBlock)) + size);
+        if (!B) {
+            perror("malloc arena block");
+            exit(EXIT_FAILURE);
+        }
+        B->size = size;
+        B->used = 0;
+        B->next = A->head;
+        A->head = B;
+        A->nblocks++;
+    }
+    void *p = block_data(B) + B->used;
+    B->used += bytes;
+    A->nallocs++;
+    A->bytes += bytes;
+    return p;
+}
+
+Arena *arena_new(size_t block_size) {
+    Arena *A = (Arena*)malloc(sizeof(Arena));
+    if (!A) {
+        perror("malloc arena");
+        exit(EXIT_FAILURE);
+    }
+    *A = arena_create(block_size);
+    return A;
+}
+
+void arena_free(Arena *A) {
+    if (!A) return;
+    ArenaBlock *B = A->head;
+    while (B) {
+        ArenaBlock *next = B->next;
+        free(B);
+        B = next;
+    }
+    *A = arena_create(A->block_size);
+}
+
+void arena_delete(Arena *A) {
+    if (!A) return;
+    arena_free(A);
+    free(A);
+}
@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+   Allocateur par arène : les objets sont découpés dans de grands blocs
+   chaînés et libérés tous ensemble par arena_free (un free par bloc).
+   Pas de libération individuelle. Non thread-safe : une arène par
+   structure (graphe, partition), remplie par un seul thread.
+*/
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t             size;   // octets utilisables dans data
+    size_t             used;
+    // les données suivent l’en-tête, alignées sur ARENA_ALIGN
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;          // bloc courant (les plus anciens suivent)
+    size_t      block_size;    // taille par défaut d’un nouveau bloc
+    size_t      nblocks;       // blocs alloués (= appels à malloc)
+    size_t      nallocs;       // objets servis par arena_alloc
+    size_t      bytes;         // octets servis par arena_alloc
+} Arena;
+
+#define ARENA_ALIGN 16
+
+// Crée une arène vide ; block_size = 0 : 64 Ko
+Arena arena_create(size_t block_size);
+
+// Alloue bytes octets alignés sur ARENA_ALIGN (arrêt si plus de mémoire)
+void *arena_alloc(Arena *A, size_t bytes);
+
+// Arène allouée sur le tas (pour les structures qui la possèdent)
+Arena *arena_new(size_t block_size);
+
+// Libère tous les blocs ; l’arène reste utilisable (vide)
+void arena_free(Arena *A);
+
+// arena_free puis libération de l’arène elle-même (créée par arena_new)
+void arena_delete(Arena *A);
+
+#endif // ARENA_H
@@ -0,0 +1,323 @@
+#include "batch.h"
+#include "loader.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "caracteristiques.h"
+#include "stationary.h"
+#include "threadpool.h"
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+BatchOptions batch_default_options(void) {
+    BatchOptions opt;
+    opt.nthreads = 0;
+    opt.out_dir = ".";
+    return opt;
+}
+
+
+// ============================================================================
+//  Liste des fichiers
+// ============================================================================
+
+static void files_push(char ***files, int *count, const char *path) {
+    // capacité implicite : puissance de 2 atteinte par count
+    if ((*count & (*count - 1)) == 0) {
+        int nc = (*count < 8) ? 8 : *count * 2;
+        char **nf = (char**)realloc(*files, nc * sizeof(char*));
+        if (!nf) {
+            perror("realloc file list");
+            exit(EXIT_FAILURE);
+        }
+        *files = nf;
+    }
+    char *copy = (char*)malloc(strlen(path) + 1);
+    if (!copy) {
+        perror("malloc file name");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(copy, path);
+    (*files)[(*count)++] = copy;
+}
+
+static int cmp_names(const void *a, const void *b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+void batch_collect(const char *path, char ***files, int *count) {
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR *d = opendir(path);
+        if (!d) {
+            perror("Could not open directory");
+            return;
+        }
+        int first = *count;
+        size_t plen = strlen(path);
+        struct dirent *e;
+        while ((e = readdir(d)) != NULL) {
+            if (e->d_name[0] == '.') continue;
+            char *full = (char*)malloc(plen + strlen(e->d_name) + 2);
+            if (!full) {
+                perror("malloc file name");
+                exit(EXIT_FAILURE);
+            }
+            sprintf(full, "%s/%s", path, e->d_name);
+            if (stat(full, &st) == 0 && S_ISREG(st.st_mode))
+                files_push(files, count, full);
+            free(full);
+        }
+        closedir(d);
+        qsort(*files + first, *count - first, sizeof(char*), cmp_names);
+        return;
+    }
+#endif
+    files_push(files, count, path);
+}
+
+void batch_free_files(char **files, int count) {
+    for (int i = 0; i < count; ++i) free(files[i]);
+    free(files);
+}
+
+
+// ============================================================================
+//  Une chaîne
+// ============================================================================
+
+static const char *base_name(const char *path) {
+    const char *b = strrchr(path, '/');
+#ifdef _WIN32
+    const char *w = strrchr(path, '\\');
+    if (w && (!b || w > b)) b = w;
+#endif
+    return b ? b + 1 : path;
+}
+
+// Fichier de résultats détaillés d’une chaîne : <out_dir>/<nom>.result.txt,
+// ou <out_dir>/<rang>-<nom>.result.txt si rank > 0. Rend 0 si le fichier
+// n’a pas pu être écrit.
+static int write_chain_file(const BatchOptions *opt, int rank, const ChainResult *R,
+                             const LoadReport *LR, const TarjanPartition *P,
+                             const Classification *K, const t_link_array *H, const prob_t *pi) {
+    if (!opt->out_dir) return 1;
+    const char *name = base_name(R->path);
+    char *out = (char*)malloc(strlen(opt->out_dir) + strlen(name) + 32);
+    if (!out) {
+        perror("malloc result name");
+        exit(EXIT_FAILURE);
+    }
+    if (rank > 0) sprintf(out, "%s/%d-%s.result.txt", opt->out_dir, rank, name);
+    else sprintf(out, "%s/%s.result.txt", opt->out_dir, name);
+    FILE *f = fopen(out, "w");
+    if (!f) {
+        perror("Could not open result file");
+        free(out);
+        return 0;
+    }
+
+    fprintf(f, "Chaine %s : %d sommets, %lld arcs\n", R->path, R->n, (long long)R->m);
+    fprintf(f, "Markov : %s", R->is_markov ? "oui" : "non");
+    if (R->duplicates > 0) fprintf(f, " (%lld arcs en double fusionnes)", (long long)R->duplicates);
+    fprintf(f, "\n");
+    for (int i = 0; i < LR->bad_rows; ++i)
+        fprintf(f, "Sommet %d : somme = %.2f (non valide)\n", LR->bad_vertices[i], LR->bad_sums[i]);
+
+    fprintf(f, "\nClasses (%d) :\n", P->size);
+    for (int c = 0; c < P->size; ++c) {
+        const TarjanClass *C = &P->classes[c];
+        fprintf(f, "%s : %s {", C->name, K->persistent[c] ? "persistante" : "transitoire");
+        for (int k = 0; k < C->size; ++k)
+            fprintf(f, k ? ",%d" : "%d", C->members[k]);
+        fprintf(f, "}%s", K->absorbing[c] ? " absorbant" : "");
+        if (K->persistent[c] && K->period[c] > 1) fprintf(f, " periode %d", K->period[c]);
+        fprintf(f, "\n");
+    }
+
+    fprintf(f, "\nHasse (%d liens) :\n", H->size);
+    for (int i = 0; i < H->size; ++i)
+        fprintf(f, "%s -> %s\n", P->classes[H->data[i].from].name, P->classes[H->data[i].to].name);
+
+    fprintf(f, "\nDistribution limite (depart uniforme) :\n");
+    for (int v = 1; v <= R->n; ++v)
+        fprintf(f, "%.4f%c", pi[v], v == R->n ? '\n' : ' ');
+
+    int written = !ferror(f);
+    if (fclose(f) != 0) written = 0;
+    if (!written) perror("Could not write result file");
+    free(out);
+    return written;
+}
+
+static ChainResult analyze_chain(const char *path, int rank, const BatchOptions *opt) {
+    ChainResult R;
+    memset(&R, 0, sizeof(R));
+    R.path = path;
+    double t0 = now_sec();
+
+    // les lecteurs arrêtent le programme sur une erreur : on vérifie
+    // d’abord que le fichier s’ouvre et commence par un nombre de sommets.
+    // Un tube (FIFO, <(...)) ne se relit pas : on le laisse au lecteur.
+    int regular = 1;
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path, &st) == 0 && !S_ISREG(st.st_mode)) regular = 0;
+#endif
+    if (regular) {
+        FILE *f = fopen(path, "rb");
+        int n = 0;
+        if (!f || fscanf(f, "%d", &n) != 1 || n < 0) {
+            snprintf(R.error, sizeof(R.error), "%s", f ? "nombre de sommets illisible" : "fichier illisible");
+            if (f) fclose(f);
+            return R;
+        }
+        fclose(f);
+    }
+
+    // 1) lecture validée
+    LoadReport LR;
+    CsrGraph G = readGraphChecked(path, 1, &LR);
+    R.ok = 1;
+    R.n = G.n;
+    R.m = G.m;
+    R.is_markov = LR.is_markov;
+    R.duplicates = LR.duplicates;
+    R.bad_rows = LR.bad_rows;
+
+    // 2) classes et liens entre classes
+    TarjanPartition P = tarjan_run_csr(&G);
+    t_link_array L;
+    build_class_links_csr(&G, &P, &L);
+    R.classes = P.size;
+
+    // 3) caractéristiques (une passe sur les arcs)
+    Classification K = classify_classes(&G, &P);
+    R.transient = K.transient_count;
+    R.persistent = K.persistent_count;
+    R.absorbing = K.absorbing_count;
+
+    // 4) Hasse
+    transitiveReduction(&L, P.size);
+    R.hasse_links = L.size;
+
+    // 5) distribution limite (un seul thread : le parallélisme est entre chaînes)
+    StationaryOptions sopt = stationary_default_options();
+    prob_t *pi = (prob_t*)malloc(((size_t)G.n + 1) * sizeof(prob_t));
+    if (!pi) {
+        perror("malloc pi");
+        exit(EXIT_FAILURE);
+    }
+    LimitReport lim = stationary_limit(&G, &P, NULL, &sopt, 1, pi);
+    R.limit_converged = lim.converged_classes;
+
+    R.seconds = now_sec() - t0;
+    if (!write_chain_file(opt, rank, &R, &LR, &P, &K, &L, pi)) {
+        R.ok = 0;
+        snprintf(R.error, sizeof(R.error), "fichier de resultats non ecrit");
+    }
+
+    free(pi);
+    classification_free(&K);
+    free(L.data);
+    partition_free(&P);
+    load_report_free(&LR);
+    csr_free(&G);
+    return R;
+}
+
+ChainResult batch_analyze(const char *path, const BatchOptions *opt) {
+    return analyze_chain(path, 0, opt);
+}
+
+
+// ============================================================================
+//  Lot de chaînes sur le pool
+// ============================================================================
+
+typedef struct {
+    const char         *path;
+    int                 rank;     // > 0 : préfixe du fichier de résultats
+    const BatchOptions *opt;
+    ChainResult        *result;
+} BatchJob;
+
+static void batch_task(void *arg) {
+    BatchJob *J = (BatchJob*)arg;
+    *J->result = analyze_chain(J->path, J->rank, J->opt);
+}
+
+// 1 si deux fichiers du lot ont le même nom (dossiers différents, ou même
+// fichier donné deux fois) : leurs fichiers de résultats se confondraient
+static int has_duplicate_names(char **files, int count) {
+    const char **names = (const char**)malloc((count > 0 ? count : 1) * sizeof(char*));
+    if (!names) {
+        perror("malloc batch names");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; ++i) names[i] = base_name(files[i]);
+    qsort(names, count, sizeof(char*), cmp_names);
+    int dup = 0;
+    for (int i = 1; i < count && !dup; ++i) dup = (strcmp(names[i - 1], names[i]) == 0);
+    free(names);
+    return dup;
+}
+
+double batch_run(char **files, int count, const BatchOptions *opt, ChainResult *results) {
+    BatchOptions def = batch_default_options();
+    if (!opt) opt = &def;
+    double t0 = now_sec();
+    if (count <= 0) return 0.0;
+
+    BatchJob *jobs = (BatchJob*)malloc(count * sizeof(BatchJob));
+    if (!jobs) {
+        perror("malloc batch jobs");
+        exit(EXIT_FAILURE);
+    }
+    int nthreads = opt->nthreads > 0 ? opt->nthreads : pool_default_threads();
+    if (nthreads > count) nthreads = count;
+
+    // homonymes : tout le lot est numéroté (<rang>-<nom>), le rang rend
+    // chaque nom unique quel que soit le nom des autres fichiers
+    int numbered = opt->out_dir && has_duplicate_names(files, count);
+
+    ThreadPool TP;
+    pool_init(&TP, nthreads);
+    for (int i = 0; i < count; ++i) {
+        jobs[i].path = files[i];
+        jobs[i].rank = numbered ? i + 1 : 0;
+        jobs[i].opt = opt;
+        jobs[i].result = &results[i];
+        pool_submit(&TP, batch_task, &jobs[i]);
+    }
+    pool_wait(&TP);
+    pool_destroy(&TP);
+    free(jobs);
+    return now_sec() - t0;
+}
+
+void batch_print_summary(FILE *out, const ChainResult *results, int count) {
+    fprintf(out, "%-32s %9s %11s %6s %8s %6s %6s %6s %9s\n",
+            "chaine", "sommets", "arcs", "markov", "classes", "pers.", "absorb", "hasse", "temps (s)");
+    for (int i = 0; i < count; ++i) {
+        const ChainResult *R = &results[i];
+        if (!R->ok) {
+            fprintf(out, "%-32s erreur : %s\n", base_name(R->path), R->error);
+            continue;
+        }
+        fprintf(out, "%-32s %9d %11lld %6s %8d %6d %6d %6d %9.3f\n",
+                base_name(R->path), R->n, (long long)R->m, R->is_markov ? "oui" : "non",
+                R->classes, R->persistent, R->absorbing, R->hasse_links, R->seconds);
+    }
+}
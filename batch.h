@@ -0,0 +1,62 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+#include "graph.h"
+
+/*
+   Analyse d’un lot de chaînes : chaque fichier passe par toute la chaîne
+   de traitement (lecture validée, vérification Markov, Tarjan, Hasse,
+   caractéristiques, distribution limite) sur un thread du pool. Chaque
+   chaîne écrit son propre fichier de résultats ; le bilan de toutes les
+   chaînes est gardé dans l’ordre des fichiers.
+*/
+
+// Bilan d’une chaîne
+typedef struct {
+    const char *path;         // fichier d’entrée
+    int         ok;           // 0 : fichier illisible ou résultats non écrits (error renseigné)
+    char        error[64];
+    int         n;
+    int64_t     m;            // arcs après fusion des doublons
+    int         is_markov;
+    int64_t     duplicates;
+    int         bad_rows;
+    int         classes;
+    int         transient;    // classes transitoires
+    int         persistent;   // classes persistantes (fermées)
+    int         absorbing;    // états absorbants
+    int         hasse_links;  // liens après réduction transitive
+    int         limit_converged; // classes fermées dont la limite a convergé
+    double      seconds;      // temps de traitement de la chaîne
+} ChainResult;
+
+typedef struct {
+    int         nthreads;     // <= 0 : un par cœur
+    const char *out_dir;      // fichiers <out_dir>/<nom>.result.txt (NULL : aucun)
+} BatchOptions;
+
+// <nom> est le nom du fichier d’entrée avec son extension (exemple3.txt
+// -> exemple3.txt.result.txt). Si deux entrées du lot ont le même nom,
+// chaque fichier de résultats du lot est préfixé par le rang de son entrée
+// dans la liste (1-exemple3.txt.result.txt, ...).
+
+BatchOptions batch_default_options(void);
+
+// Liste des fichiers à traiter : un fichier, ou les fichiers réguliers
+// d’un répertoire (triés par nom). Ajoute à *files / *count (à libérer
+// avec batch_free_files).
+void batch_collect(const char *path, char ***files, int *count);
+void batch_free_files(char **files, int count);
+
+// Traite une chaîne ; résultats dans <out_dir>/<nom>.result.txt
+ChainResult batch_analyze(const char *path, const BatchOptions *opt);
+
+// Traite tous les fichiers ; results (count cases) est rempli dans l’ordre
+// des fichiers. Renvoie le temps total écoulé.
+double batch_run(char **files, int count, const BatchOptions *opt, ChainResult *results);
+
+// Tableau récapitulatif (une ligne par chaîne)
+void batch_print_summary(FILE *out, const ChainResult *results, int count);
+
+#endif // BATCH_H
@@ -0,0 +1,1078 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "graph.h"
+#include "tarjan.h"
+#include "scc.h"
+#include "threadpool.h"
+#include "matrix.h"
+#include "stationary.h"
+#include "reach.h"
+#include "dynscc.h"
+#include "loader.h"
+#include "batch.h"
+#include "caracteristiques.h"
+#include "absorption.h"
+#include "blockmatrix.h"
+
+/*
+   Banc d’essai : compare les moteurs sur des graphes générés.
+   Usage : bench [section] [n]
+     section : scc | mult | stationary | limit | links | hasse | reach | alloc | precision | dynscc | stream | validate | batch | mermaid | classify | absorb | blocks | converge | all (défaut all)
+     n       : nombre de sommets des graphes générés (défaut 1000000)
+*/
+
+// ---------- Comptage des allocations (glibc) ----------
+// Le banc remplace malloc & co. pour compter les appels au tas ; ailleurs
+// les compteurs restent à 0.
+static atomic_long bench_heap_calls;
+
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+
+void *malloc(size_t size) {
+    atomic_fetch_add_explicit(&bench_heap_calls, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+void *calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&bench_heap_calls, 1, memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+void *realloc(void *p, size_t size) {
+    atomic_fetch_add_explicit(&bench_heap_calls, 1, memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+#endif
+
+static long heap_calls(void) {
+    return atomic_load(&bench_heap_calls);
+}
+
+
+// ---------- Outils ----------
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Générateur pseudo-aléatoire reproductible (xorshift)
+static unsigned long long rng_state = 88172645463325252ULL;
+static unsigned int rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned int)(rng_state >> 16);
+}
+
+// Graphe aléatoire : d arcs sortants uniformes par sommet (une grosse SCC)
+static CsrGraph gen_random(int n, int d) {
+    EdgeList E = edges_create();
+    for (int u = 1; u <= n; ++u)
+        for (int k = 0; k < d; ++k)
+            edges_push(&E, u, 1 + (int)(rng_next() % (unsigned)n), 1.0f / d);
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Suite de cycles de taille s, chacun relié au suivant (beaucoup de SCC)
+static CsrGraph gen_cycles(int n, int s) {
+    EdgeList E = edges_create();
+    for (int u = 1; u <= n; ++u) {
+        int base = ((u - 1) / s) * s;
+        int last = (base + s < n) ? base + s : n;
+        int next = (u == last) ? base + 1 : u + 1;
+        if (u == base + 1 && last < n) {
+            edges_push(&E, u, next, 0.5f);
+            edges_push(&E, u, base + s + 1, 0.5f);
+        } else {
+            edges_push(&E, u, next, 1.0f);
+        }
+    }
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Processus de naissance et de mort : une seule SCC, DFS de profondeur n
+static CsrGraph gen_birth_death(int n) {
+    EdgeList E = edges_create();
+    for (int u = 1; u <= n; ++u) {
+        if (u < n) edges_push(&E, u, u + 1, 0.5f);
+        if (u > 1) edges_push(&E, u, u - 1, 0.5f);
+    }
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Anneau u -> u+1 plus d-1 arcs aléatoires : une seule classe, fermée
+static CsrGraph gen_ring(int n, int d) {
+    EdgeList E = edges_create();
+    for (int u = 1; u <= n; ++u) {
+        edges_push(&E, u, (u < n) ? u + 1 : 1, 1.0f / d);
+        for (int k = 1; k < d; ++k)
+            edges_push(&E, u, 1 + (int)(rng_next() % (unsigned)n), 1.0f / d);
+    }
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Îlots fermés de taille s (anneau + une corde aléatoire) alimentés par
+// n/10 états transitoires : des milliers de petites classes persistantes
+static CsrGraph gen_islands(int n, int s) {
+    EdgeList E = edges_create();
+    int ntrans = n / 10;
+    int nisl = n - ntrans;
+    for (int u = 1; u <= ntrans; ++u) {
+        edges_push(&E, u, 1 + (int)(rng_next() % (unsigned)n), 0.5f);
+        edges_push(&E, u, ntrans + 1 + (int)(rng_next() % (unsigned)nisl), 0.5f);
+    }
+    for (int u = ntrans + 1; u <= n; ++u) {
+        int base = ntrans + ((u - ntrans - 1) / s) * s;
+        int last = (base + s < n) ? base + s : n;
+        int next = (u == last) ? base + 1 : u + 1;
+        int chord = base + 1 + (int)(rng_next() % (unsigned)(last - base));
+        edges_push(&E, u, next, 0.7f);
+        edges_push(&E, u, chord, 0.3f);
+    }
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Graphe sans cycle : u -> d successeurs aléatoires plus grands que u.
+// Chaque sommet est sa propre classe, presque tous les arcs sont des liens
+static CsrGraph gen_dag(int n, int d) {
+    EdgeList E = edges_create();
+    for (int u = 1; u < n; ++u)
+        for (int k = 0; k < d; ++k)
+            edges_push(&E, u, u + 1 + (int)(rng_next() % (unsigned)(n - u)), 1.0f / d);
+    CsrGraph G = csr_from_edges(n, &E);
+    edges_free(&E);
+    return G;
+}
+
+// Deux partitions sont identiques si elles regroupent les mêmes sommets
+static int same_partition(const TarjanPartition *A, const TarjanPartition *B, int n) {
+    if (A->size != B->size) return 0;
+    int *ma = build_vertex_to_class(A, n);
+    int *mb = build_vertex_to_class(B, n);
+    int *link = (int*)malloc(A->size * sizeof(int));
+    int ok = (link != NULL);
+    for (int c = 0; ok && c < A->size; ++c) link[c] = -1;
+    for (int v = 1; ok && v <= n; ++v) {
+        if (link[ma[v]] == -1) link[ma[v]] = mb[v];
+        else if (link[ma[v]] != mb[v]) ok = 0;
+    }
+    for (int c = 0; ok && c < A->size; ++c)
+        if (A->classes[c].size != B->classes[link[c]].size) ok = 0;
+    free(link);
+    free(ma);
+    free(mb);
+    return ok;
+}
+
+
+// ---------- Section SCC : Tarjan contre forward-backward parallèle ----------
+static void bench_scc_one(const char *label, const CsrGraph *G) {
+    int nthreads = pool_default_threads();
+
+    double t0 = now_sec();
+    TarjanPartition P = scc_run(G, SCC_TARJAN, 0);
+    double t1 = now_sec();
+    TarjanPartition Q = scc_run(G, SCC_PARALLEL, nthreads);
+    double t2 = now_sec();
+
+    printf("%-14s n=%-9d m=%-10lld classes=%-9d tarjan %8.3f s  parallel(%d) %8.3f s  %s\n",
+           label, G->n, (long long)G->m, P.size, t1 - t0, nthreads, t2 - t1,
+           same_partition(&P, &Q, G->n) ? "ok" : "DIFFERENT");
+
+    partition_free(&P);
+    partition_free(&Q);
+}
+
+static void bench_scc(int n) {
+    printf("=== SCC : Tarjan / parallele ===\n");
+    CsrGraph G;
+
+    G = gen_random(n, 4);
+    bench_scc_one("aleatoire", &G);
+    csr_free(&G);
+
+    G = gen_cycles(n, 8);
+    bench_scc_one("cycles(8)", &G);
+    csr_free(&G);
+
+    G = gen_birth_death(n);
+    bench_scc_one("naissance-mort", &G);
+    csr_free(&G);
+}
+
+
+// ---------- Section multiplication : noyau par blocs contre triple boucle ----------
+static void bench_mult(int n) {
+    printf("=== Multiplication dense n=%d (noyau %s, %s) ===\n", n, matrix_kernel_name(),
+           MARKOV_PRECISION_NAME);
+
+    // chaîne dense aléatoire (pire cas : aucun zéro à sauter)
+    Matrix A = matrix_create(n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            MAT(&A, i, j) = (prob_t)((rng_next() % 1000) / (1000.0 * n));
+
+    Matrix R = matrix_create(n);
+    double t0 = now_sec();
+    matrix_mult(&A, &A, &R);
+    double t1 = now_sec();
+
+    // référence : triple boucle i-k-j sur le même stockage
+    Matrix Ref = matrix_create(n);
+    for (int i = 0; i < n; ++i)
+        for (int k = 0; k < n; ++k)
+            for (int j = 0; j < n; ++j)
+                MAT(&Ref, i, j) += MAT(&A, i, k) * MAT(&A, k, j);
+    double t2 = now_sec();
+
+    double flops = 2.0 * n * (double)n * n;
+    printf("blocs %8.3f s (%6.2f GFlop/s)   triple boucle %8.3f s (%6.2f GFlop/s)   ecart %.2e\n",
+           t1 - t0, flops / (t1 - t0) * 1e-9, t2 - t1, flops / (t2 - t1) * 1e-9,
+           matrix_diff(&R, &Ref));
+
+    matrix_free(&A);
+    matrix_free(&R);
+    matrix_free(&Ref);
+}
+
+
+// ---------- Section distribution stationnaire creuse ----------
+static void bench_stationary(int n) {
+    printf("=== Distribution stationnaire creuse n=%d ===\n", n);
+    CsrGraph G = gen_ring(n, 4);
+    TarjanPartition P = tarjan_run_csr(&G);
+
+    prob_t *pi = (prob_t*)malloc(((size_t)n + 1) * sizeof(prob_t));
+    int *pos = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    for (int v = 0; v <= n; ++v) pos[v] = -1;
+    StationaryOptions opt = stationary_default_options();
+    opt.tol = 1e-6;
+
+    double t0 = now_sec();
+    StationaryReport R = stationary_class(&G, &P, 0, &opt, pos, pi);
+    double t1 = now_sec();
+
+    double dense_gb = (double)n * n * sizeof(prob_t) * 1e-9;
+    printf("classes=%d  %d iterations (residu %.2e)  %.3f s, %.2f ns/arc/iteration"
+           "  (une matrice dense occuperait %.1f Go)\n",
+           P.size, R.iterations, R.residual, t1 - t0,
+           (t1 - t0) * 1e9 / ((double)G.m * (R.iterations > 0 ? R.iterations : 1)), dense_gb);
+
+    free(pos);
+    free(pi);
+    partition_free(&P);
+    csr_free(&G);
+}
+
+
+// ---------- Section distribution limite : classes résolues en parallèle ----------
+static void bench_limit(int n) {
+    printf("=== Distribution limite, petites classes fermees n=%d ===\n", n);
+    CsrGraph G = gen_islands(n, 50);
+    TarjanPartition P = tarjan_run_csr(&G);
+    prob_t *pi = (prob_t*)malloc(((size_t)n + 1) * sizeof(prob_t));
+    StationaryOptions opt = stationary_default_options();
+
+    int threads[2] = { 1, pool_default_threads() };
+    for (int t = 0; t < 2; ++t) {
+        double t0 = now_sec();
+        LimitReport L = stationary_limit(&G, &P, NULL, &opt, threads[t], pi);
+        double t1 = now_sec();
+        printf("threads=%-3d classes fermees=%-7d (convergees %d, max %d iterations)  %.3f s\n",
+               threads[t], L.closed_classes, L.converged_classes, L.max_iterations, t1 - t0);
+    }
+
+    free(pi);
+    partition_free(&P);
+    csr_free(&G);
+}
+
+
+// ---------- Section liens entre classes (graphe condensé) ----------
+static void bench_links(int n) {
+    printf("=== Liens entre classes n=%d ===\n", n);
+    CsrGraph G = gen_dag(n, 4);
+
+    double t0 = now_sec();
+    TarjanPartition P = tarjan_run_csr(&G);
+    double t1 = now_sec();
+    t_link_array L;
+    build_class_links_csr(&G, &P, &L);
+    double t2 = now_sec();
+
+    printf("classes=%d arcs=%lld liens=%d   tarjan %.3f s   liens %.3f s (%.1f M arcs/s)\n",
+           P.size, (long long)G.m, L.size, t1 - t0, t2 - t1, G.m / (t2 - t1) * 1e-6);
+
+    free(L.data);
+    partition_free(&P);
+    csr_free(&G);
+}
+
+
+// Liens aléatoires d'un DAG de c classes (numérotées dans le désordre) :
+// d liens par classe vers des classes plus loin dans l'ordre caché
+static t_link_array gen_class_dag(int c, int d) {
+    int *perm = (int*)malloc(c * sizeof(int));
+    for (int i = 0; i < c; ++i) perm[i] = i;
+    for (int i = c - 1; i > 0; --i) {
+        int j = (int)(rng_next() % (unsigned)(i + 1));
+        int t = perm[i]; perm[i] = perm[j]; perm[j] = t;
+    }
+    t_link_array L;
+    L.size = 0;
+    L.capacity = (c - 1) * d;
+    L.data = (t_link*)malloc((L.capacity > 0 ? L.capacity : 1) * sizeof(t_link));
+    for (int i = 0; i < c - 1; ++i)
+        for (int k = 0; k < d; ++k) {
+            // cibles proches : beaucoup de chemins de longueur >= 2
+            int span = (c - 1 - i < 64) ? c - 1 - i : 64;
+            int j = i + 1 + (int)(rng_next() % (unsigned)span);
+            L.data[L.size].from = perm[i];
+            L.data[L.size].to = perm[j];
+            L.size++;
+        }
+    free(perm);
+    return L;
+}
+
+// ---------- Section diagramme de Hasse : réduction transitive ----------
+static void bench_hasse(int n) {
+    printf("=== Reduction transitive ===\n");
+
+    // petit cas : l'ancienne triple boucle reste mesurable
+    t_link_array A = gen_class_dag(2000, 3);
+    t_link_array B = A;
+    B.data = (t_link*)malloc(A.size * sizeof(t_link));
+    memcpy(B.data, A.data, A.size * sizeof(t_link));
+    int before = A.size;
+
+    double t0 = now_sec();
+    removeTransitiveLinks(&A);
+    double t1 = now_sec();
+    transitiveReduction(&B, 2000);
+    double t2 = now_sec();
+    printf("classes=2000 liens=%d   triple boucle %.3f s -> %d liens   bitsets %.4f s -> %d liens\n",
+           before, t1 - t0, A.size, t2 - t1, B.size);
+    free(A.data);
+    free(B.data);
+
+    // grand cas : seule la nouvelle version passe à l'échelle
+    int c = (n < 100000) ? n : 100000;
+    t_link_array G = gen_class_dag(c, 4);
+    before = G.size;
+    t0 = now_sec();
+    transitiveReduction(&G, c);
+    t1 = now_sec();
+    printf("classes=%d liens=%d   bitsets %.3f s -> %d liens\n", c, before, t1 - t0, G.size);
+    free(G.data);
+}
+
+
+// ---------- Section accessibilité entre classes ----------
+// Index dense, puis index sous un budget moitié du dense (creux ou refusé)
+static void bench_reach_graph(const char *label, const CsrGraph *G) {
+    TarjanPartition P = tarjan_run_csr(G);
+    t_link_array L;
+    build_class_links_csr(G, &P, &L);
+    int c = P.size;
+
+    double t0 = now_sec();
+    ReachIndex D = reach_build(&P, &L, 0);
+    double t1 = now_sec();
+    size_t budget = reach_memory(&D) / 2;
+    ReachIndex S = reach_build(&P, &L, budget);
+    double t2 = now_sec();
+
+    const int nq = 10000000;
+    int *qa = (int*)malloc(nq * sizeof(int));
+    int *qb = (int*)malloc(nq * sizeof(int));
+    for (int i = 0; i < nq; ++i) {
+        qa[i] = (int)(rng_next() % (unsigned)c);
+        qb[i] = (int)(rng_next() % (unsigned)c);
+    }
+    long hits_d = 0, hits_s = 0;
+    double t3 = now_sec();
+    for (int i = 0; i < nq; ++i) hits_d += class_reaches(&D, qa[i], qb[i]);
+    double t4 = now_sec();
+    for (int i = 0; i < nq && S.nclasses > 0; ++i) hits_s += class_reaches(&S, qa[i], qb[i]);
+    double t5 = now_sec();
+
+    printf("%s, %d classes\n", label, c);
+    printf("  dense : %.3f s, %.1f Mo, %.1f M requetes/s\n", t1 - t0,
+           reach_memory(&D) / 1048576.0, nq / (t4 - t3) * 1e-6);
+    if (S.nclasses > 0)
+        printf("  creux (budget %.1f Mo) : %.3f s, %.1f Mo, %.1f M requetes/s   (%s, %ld/%d accessibles)\n",
+               budget / 1048576.0, t2 - t1, reach_memory(&S) / 1048576.0, nq / (t5 - t4) * 1e-6,
+               hits_d == hits_s ? "identiques" : "DIFFERENTS", hits_d, nq);
+    else
+        printf("  creux (budget %.1f Mo) : refuse apres %.3f s, la fermeture ne tient pas\n",
+               budget / 1048576.0, t2 - t1);
+
+    free(qa);
+    free(qb);
+    reach_free(&D);
+    reach_free(&S);
+    free(L.data);
+    partition_free(&P);
+}
+
+static void bench_reach(int n) {
+    int c = (n < 20000) ? n : 20000;   // 20000 classes : 50 Mo en dense
+    printf("=== Accessibilite entre classes ===\n");
+
+    // fermeture dense : le creux coûterait plus que les bits
+    CsrGraph G = gen_dag(c, 4);
+    bench_reach_graph("DAG aleatoire (fermeture dense)", &G);
+    csr_free(&G);
+
+    // îlots fermés alimentés par des transitoires : fermeture creuse
+    G = gen_islands(c, 2);
+    bench_reach_graph("ilots (fermeture creuse)", &G);
+    csr_free(&G);
+}
+
+
+// ---------- Section allocations : cellules et classes en arène ----------
+static void bench_alloc(int n) {
+    printf("=== Allocations n=%d (cycles de 8) ===\n", n);
+    CsrGraph G = gen_cycles(n, 8);
+
+    for (int pooled = 0; pooled < 2; ++pooled) {
+        long c0 = heap_calls();
+        double t0 = now_sec();
+        AdjList A = adj_from_csr(&G, pooled);
+        double t1 = now_sec();
+        long c1 = heap_calls();
+        TarjanPartition P = tarjan_run(&A);
+        long c2 = heap_calls();
+        int nclasses = P.size;
+        double t2 = now_sec();
+        partition_free(&P);
+        double t3 = now_sec();
+        adj_free(&A);
+        double t4 = now_sec();
+        printf("%-7s liste: %9ld allocations %.3f s, liberation %.3f s   "
+               "tarjan: %7ld allocations (%d classes), liberation %.3f s\n",
+               pooled ? "arene" : "malloc", c1 - c0, t1 - t0, t4 - t3,
+               c2 - c1, nclasses, t3 - t2);
+    }
+    csr_free(&G);
+}
+
+
+// ---------- Section précision : débit et dérive de la boucle de convergence ----------
+// À lancer sur trois builds (-DMARKOV_PRECISION=float|double|mixed) pour
+// comparer le coût mémoire et la précision de chaque mode.
+static void bench_precision(int n) {
+    const int steps = 20;
+    printf("=== Precision %s (prob_t %zu octets, acc_t %zu octets) n=%d, %d produits ===\n",
+           MARKOV_PRECISION_NAME, sizeof(prob_t), sizeof(acc_t), n, steps);
+
+    // chaîne dense stochastique (lignes normalisées en double)
+    Matrix M = matrix_create(n);
+    for (int i = 0; i < n; ++i) {
+        double row = 0.0;
+        for (int j = 0; j < n; ++j) {
+            MAT(&M, i, j) = (prob_t)(1 + rng_next() % 1000);
+            row += MAT(&M, i, j);
+        }
+        for (int j = 0; j < n; ++j) MAT(&M, i, j) = (prob_t)(MAT(&M, i, j) / row);
+    }
+
+    // même boucle que main.c : A ← A × M, écart L1 à chaque pas
+    Matrix A = matrix_create(n), B = matrix_create(n);
+    matrix_copy(&A, &M);
+    acc_t d = 0;
+    double t0 = now_sec();
+    for (int s = 0; s < steps; ++s) {
+        matrix_mult(&A, &M, &B);
+        d = matrix_diff(&A, &B);
+        matrix_copy(&A, &B);
+    }
+    double t1 = now_sec();
+
+    // une matrice stochastique le reste : l'écart des sommes de lignes à 1
+    // mesure l'erreur d'arrondi accumulée
+    double drift = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double row = 0.0;
+        for (int j = 0; j < n; ++j) row += MAT(&A, i, j);
+        if (fabs(row - 1.0) > drift) drift = fabs(row - 1.0);
+    }
+
+    double flops = 2.0 * n * (double)n * n * steps;
+    double mb = (double)n * A.ld * sizeof(prob_t) / (1024.0 * 1024.0);
+    printf("%8.3f s  %6.2f GFlop/s  %.1f Mo par matrice  derive max |somme ligne - 1| = %.2e"
+           "  (dernier ecart %.2e)\n",
+           t1 - t0, flops / (t1 - t0) * 1e-9, mb, drift, (double)d);
+
+    matrix_free(&M);
+    matrix_free(&A);
+    matrix_free(&B);
+}
+
+
+// ---------- Section SCC incrémentales : lots d’ajouts / suppressions ----------
+// Flux aléatoire sur des cycles de 8 : ajouts locaux (cibles à ±100, ce qui
+// crée des fusions) et suppressions d’arcs existants (redécoupages).
+/*
+   Un régime de mises à jour : suppressions d’arcs existants et ajouts
+   u -> v avec |u - v| <= span (span = 0 : v dans le même cycle de 8 que u,
+   les classes restent petites ; span = 100 : les cycles voisins fusionnent
+   en grandes classes et les lots finissent en recalcul complet).
+*/
+static void bench_dynscc_regime(const char *label, int n, int span) {
+    const int batches = 50, batch = 2000;
+    CsrGraph G = gen_cycles(n, 8);
+    DynScc S = dynscc_create(&G, NULL);
+
+    EdgeUpdate *U = (EdgeUpdate*)malloc(batch * sizeof(EdgeUpdate));
+    if (!U) {
+        perror("malloc updates");
+        exit(EXIT_FAILURE);
+    }
+    DynSccReport total;
+    memset(&total, 0, sizeof(total));
+    double busy = 0.0;
+    for (int b = 0; b < batches; ++b) {
+        for (int i = 0; i < batch; ++i) {
+            int u = 1 + (int)(rng_next() % (unsigned)n);
+            const DynEdges *E = &S.out[u];
+            if ((rng_next() & 1) && E->size > 0) {
+                U[i] = (EdgeUpdate){ u, E->dest[rng_next() % (unsigned)E->size], 0, 0 };
+            } else {
+                int v;
+                if (span > 0) v = u - span + (int)(rng_next() % (unsigned)(2 * span + 1));
+                else v = ((u - 1) / 8) * 8 + 1 + (int)(rng_next() % 8);
+                if (v < 1) v = 1;
+                if (v > n) v = n;
+                U[i] = (EdgeUpdate){ u, v, 0.5f, 1 };
+            }
+        }
+        DynSccReport R;
+        double a = now_sec();
+        dynscc_apply(&S, U, batch, &R);
+        busy += now_sec() - a;
+        total.inserted += R.inserted;
+        total.reweighted += R.reweighted;
+        total.deleted += R.deleted;
+        total.ignored += R.ignored;
+        total.merges += R.merges;
+        total.splits += R.splits;
+        total.checked += R.checked;
+        total.rebuilt += R.rebuilt;
+    }
+    printf("%s\n", label);
+    printf("  incremental : %.3f s, %.0f modifications/s (%d ajouts, %d poids, %d suppressions, "
+           "%d fusions, %d redecoupages / %d verifications, %d/%d lots recalcules), %d classes\n",
+           busy, (double)batches * batch / busy, total.inserted, total.reweighted, total.deleted,
+           total.merges, total.splits, total.checked, total.rebuilt, batches, dynscc_class_count(&S));
+
+    // référence : ce que coûterait chaque lot en recalcul complet
+    TarjanPartition P;
+    t_link_array L;
+    CsrGraph H;
+    dynscc_snapshot(&S, &P, &L, &H);
+    double t2 = now_sec();
+    TarjanPartition Q = tarjan_run_csr(&H);
+    t_link_array LQ = { NULL, 0, 0 };
+    build_class_links_csr(&H, &Q, &LQ);
+    double t3 = now_sec();
+    printf("  recalcul complet : %.3f s par lot, soit %.0f modifications/s a lots de %d  %s\n",
+           t3 - t2, batch / (t3 - t2), batch,
+           (same_partition(&P, &Q, n) && L.size == LQ.size) ? "ok" : "DIFFERENT");
+
+    free(L.data);
+    free(LQ.data);
+    partition_free(&P);
+    partition_free(&Q);
+    csr_free(&H);
+    dynscc_free(&S);
+    free(U);
+    csr_free(&G);
+}
+
+static void bench_dynscc(int n) {
+    printf("=== SCC incrementales n=%d, 50 lots de 2000 modifications ===\n", n);
+    CsrGraph G = gen_cycles(n, 8);
+    double t0 = now_sec();
+    DynScc S = dynscc_create(&G, NULL);
+    double t1 = now_sec();
+    printf("creation : %.3f s, %d classes\n", t1 - t0, dynscc_class_count(&S));
+    dynscc_free(&S);
+    csr_free(&G);
+
+    bench_dynscc_regime("classes locales (ajouts dans le meme cycle)", n, 0);
+    bench_dynscc_regime("grandes classes (ajouts a +-100)", n, 100);
+}
+
+
+// Écrit G au format texte du sujet ; renvoie la taille du fichier
+static long write_text_graph(const char *path, const CsrGraph *G) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror("Could not open file for writing");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "%d\n", G->n);
+    for (int u = 1; u <= G->n; ++u)
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k)
+            fprintf(f, "%d %d %.6f\n", u, G->dest[k], (double)G->prob[k]);
+    long text = ftell(f);
+    fclose(f);
+    return text;
+}
+
+
+// ---------- Section flux : lecture par blocs contre projection du fichier ----------
+static void bench_stream(int n) {
+    const char *path = "bench_stream.txt";
+    CsrGraph G = gen_random(n, 4);
+    long text = write_text_graph(path, &G);
+    FILE *f;
+
+    double graph_mb = (double)G.m * (sizeof(int) + sizeof(prob_t)) / (1024.0 * 1024.0);
+    printf("=== Lecture en flux n=%d m=%lld : texte %.1f Mo, arcs %.1f Mo, bloc %.1f Mo ===\n",
+           G.n, (long long)G.m, text / (1024.0 * 1024.0), graph_mb,
+           LOADER_STREAM_CHUNK / (1024.0 * 1024.0));
+
+    double t0 = now_sec();
+    CsrGraph A = readGraphFast(path, 1);
+    double t1 = now_sec();
+    f = fopen(path, "rb");
+    CsrGraph B = readGraphStream(f);
+    fclose(f);
+    double t2 = now_sec();
+
+    int ok = (A.m == G.m && B.m == G.m && memcmp(A.dest, B.dest, G.m * sizeof(int)) == 0);
+    printf("projection %.3f s (%.0f Mo/s)   flux %.3f s (%.0f Mo/s)  %s\n",
+           t1 - t0, text / (1024.0 * 1024.0) / (t1 - t0),
+           t2 - t1, text / (1024.0 * 1024.0) / (t2 - t1), ok ? "ok" : "DIFFERENT");
+
+    csr_free(&A);
+    csr_free(&B);
+    csr_free(&G);
+    remove(path);
+}
+
+
+// ---------- Section validation : contrôles pendant la lecture ----------
+// lecture CSR puis csr_is_markov, contre readGraphChecked (bornes, signes,
+// doublons et sommes calculés pendant la construction)
+static void bench_validate(int n) {
+    const char *path = "bench_validate.txt";
+    CsrGraph G = gen_random(n, 4);
+    write_text_graph(path, &G);
+    printf("=== Validation a la lecture n=%d m=%lld ===\n", G.n, (long long)G.m);
+
+    double t0 = now_sec();
+    CsrGraph A = readGraphFast(path, 1);
+    double t1 = now_sec();
+    bool markov = csr_is_markov(&A);
+    double t2 = now_sec();
+    LoadReport R;
+    CsrGraph B = readGraphChecked(path, 1, &R);
+    double t3 = now_sec();
+
+    printf("lecture %.3f s + csr_is_markov %.3f s = %.3f s   lecture validee %.3f s"
+           "  (markov %d/%d, %lld doublons fusionnes, ecart max %.1e)\n",
+           t1 - t0, t2 - t1, t2 - t0, t3 - t2, markov, R.is_markov,
+           (long long)R.duplicates, (double)R.max_row_error);
+
+    load_report_free(&R);
+    csr_free(&A);
+    csr_free(&B);
+    csr_free(&G);
+    remove(path);
+}
+
+
+// ---------- Section lot : chaînes analysées en parallèle ----------
+static void bench_batch(int n) {
+    const int count = 32;
+    int size = n / count > 100 ? n / count : 100;
+    char **files = NULL;
+    int nfiles = 0;
+    for (int i = 0; i < count; ++i) {
+        char path[64];
+        snprintf(path, sizeof(path), "bench_batch_%02d.txt", i);
+        CsrGraph G = (i % 2) ? gen_islands(size, 8) : gen_random(size, 4);
+        write_text_graph(path, &G);
+        csr_free(&G);
+        batch_collect(path, &files, &nfiles);
+    }
+    printf("=== Lot de %d chaines de %d sommets ===\n", count, size);
+
+    ChainResult *results = (ChainResult*)malloc(count * sizeof(ChainResult));
+    if (!results) {
+        perror("malloc results");
+        exit(EXIT_FAILURE);
+    }
+    BatchOptions opt = batch_default_options();
+    opt.out_dir = NULL;   // on ne mesure que l’analyse
+
+    opt.nthreads = 1;
+    double t1 = batch_run(files, nfiles, &opt, results);
+    int nthreads = pool_default_threads();
+    opt.nthreads = nthreads;
+    double tn = batch_run(files, nfiles, &opt, results);
+
+    int classes = 0;
+    for (int i = 0; i < count; ++i) classes += results[i].classes;
+    printf("1 thread %.3f s   %d threads %.3f s   acceleration %.2f  (%d classes au total)\n",
+           t1, nthreads, tn, t1 / tn, classes);
+
+    for (int i = 0; i < nfiles; ++i) remove(files[i]);
+    batch_free_files(files, nfiles);
+    free(results);
+}
+
+
+// ---------- Section Mermaid : tampon formaté à la main contre fprintf ----------
+// Référence : un fprintf par sommet et par arc (comme l’ancien export)
+static void mermaid_fprintf(const CsrGraph *G, const char *filename) {
+    FILE *f = fopen(filename, "wt");
+    if (!f) {
+        perror("Could not open file for writing");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "---\nconfig:\n   layout: elk\n   theme: neo\n   look: neo\n---\n\nflowchart LR\n");
+    char a[GETID_SIZE], b[GETID_SIZE];
+    for (int u = 1; u <= G->n; ++u) {
+        getId_r(u, a, sizeof(a));
+        fprintf(f, "%s((%d))\n", a, u);
+    }
+    fprintf(f, "\n");
+    for (int u = 1; u <= G->n; ++u) {
+        getId_r(u, a, sizeof(a));
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k) {
+            getId_r(G->dest[k], b, sizeof(b));
+            fprintf(f, "%s -->|%.2f|%s\n", a, G->prob[k], b);
+        }
+    }
+    fclose(f);
+}
+
+static void bench_mermaid(int n) {
+    CsrGraph G = gen_random(n, 10);
+    printf("=== Export Mermaid n=%d m=%lld ===\n", G.n, (long long)G.m);
+
+    double t0 = now_sec();
+    mermaid_fprintf(&G, "bench_mermaid_ref.txt");
+    double t1 = now_sec();
+    csr_to_mermaid(&G, "bench_mermaid.txt");
+    double t2 = now_sec();
+
+    // comparaison des deux fichiers
+    MappedFile A = mapped_file_open("bench_mermaid_ref.txt");
+    MappedFile B = mapped_file_open("bench_mermaid.txt");
+    int same = (A.size == B.size && memcmp(A.data, B.data, A.size) == 0);
+    double mb = B.size / (1024.0 * 1024.0);
+    printf("fprintf %.3f s (%.0f Mo/s)   tampon %.3f s (%.0f Mo/s)   %.1f Mo  %s\n",
+           t1 - t0, mb / (t1 - t0), t2 - t1, mb / (t2 - t1), mb, same ? "ok" : "DIFFERENT");
+    mapped_file_close(&A);
+    mapped_file_close(&B);
+
+    remove("bench_mermaid_ref.txt");
+    remove("bench_mermaid.txt");
+    csr_free(&G);
+}
+
+
+// ---------- Section classification : une passe sur les arcs contre liens + Hasse ----------
+static void bench_classify(int n) {
+    CsrGraph G = gen_islands(n, 8);
+    TarjanPartition P = tarjan_run_csr(&G);
+    printf("=== Classification n=%d m=%lld, %d classes ===\n", G.n, (long long)G.m, P.size);
+
+    double t0 = now_sec();
+    t_link_array L;
+    build_class_links_csr(&G, &P, &L);
+    transitiveReduction(&L, P.size);
+    int *closed = (int*)calloc(P.size, sizeof(int));
+    for (int c = 0; c < P.size; ++c) closed[c] = 1;
+    for (int i = 0; i < L.size; ++i) closed[L.data[i].from] = 0;
+    double t1 = now_sec();
+    Classification K = classify_classes(&G, &P);
+    double t2 = now_sec();
+
+    int agree = 1;
+    for (int c = 0; c < P.size; ++c) agree &= (closed[c] == K.persistent[c]);
+    printf("liens + Hasse %.3f s   classify_classes %.3f s (periodes comprises)   "
+           "%d persistantes, %d absorbantes, %d periodiques  %s\n",
+           t1 - t0, t2 - t1, K.persistent_count, K.absorbing_count, K.periodic_count,
+           agree ? "ok" : "DIFFERENT");
+
+    classification_free(&K);
+    free(closed);
+    free(L.data);
+    partition_free(&P);
+    csr_free(&G);
+}
+
+
+// ---------- Section absorption : Gauss-Seidel par classe contre système dense ----------
+static void bench_absorb_one(const char *label, const CsrGraph *G, int dense) {
+    TarjanPartition P = tarjan_run_csr(G);
+    Classification K = classify_classes(G, &P);
+    int target = -1;
+    for (int c = 0; c < P.size && target < 0; ++c)
+        if (K.persistent[c]) target = c;
+    printf("%s : n=%d m=%lld, %d classes transitoires, %d fermees\n", label, G->n,
+           (long long)G->m, K.transient_count, K.persistent_count);
+
+    double *h = (double*)malloc(((size_t)G->n + 1) * sizeof(double));
+    double *t = (double*)malloc(((size_t)G->n + 1) * sizeof(double));
+    double t0 = now_sec();
+    AbsorptionReport rh = absorption_probabilities(G, &P, &K, target, NULL, h);
+    AbsorptionReport rt = expected_steps(G, &P, &K, NULL, t);
+    double t1 = now_sec();
+    printf("  creux  %.3f s  (%d blocs, %d balayages%s)\n", t1 - t0, rt.blocks,
+           rh.sweeps + rt.sweeps, rh.converged && rt.converged ? "" : ", non converge");
+
+    if (dense) {
+        Matrix M = matrix_from_csr(G);
+        double t2 = now_sec();
+        Absorption A = absorption_dense(&M, &P, &K);
+        double t3 = now_sec();
+        MatrixLimitReport lr;
+        Matrix L = matrix_limit(&M, classification_period(&K), NULL, &lr);
+        double t4 = now_sec();
+
+        double err = 0.0;
+        int r = 0;
+        while (r < A.nclosed && A.closed[r] != target) r++;
+        for (int i = 0; i < A.ntransient && A.ok; ++i) {
+            double e = fabs(h[A.transient[i]] - A.absorb[(size_t)i * A.nclosed + r]);
+            double f = fabs(t[A.transient[i]] - A.steps[i]) / (1.0 + A.steps[i]);
+            if (e > err) err = e;
+            if (f > err) err = f;
+        }
+        printf("  dense  %.3f s  (ecart max %.1e)   M^n : %.3f s (%d produits)\n",
+               t3 - t2, err, t4 - t3, lr.iterations + 1);
+        matrix_free(&L);
+        absorption_free(&A);
+        matrix_free(&M);
+    }
+
+    free(h);
+    free(t);
+    classification_free(&K);
+    partition_free(&P);
+}
+
+// Arcs en double fusionnés : matrix_from_csr garde le dernier, le CSR les
+// additionne, les deux versions ne résoudraient pas le même système
+static CsrGraph merge_duplicates(CsrGraph G) {
+    EdgeList E = edges_create();
+    for (int u = 1; u <= G.n; ++u)
+        for (int64_t k = G.row[u]; k < G.row[u + 1]; ++k)
+            edges_push(&E, u, G.dest[k], G.prob[k]);
+    CsrGraph M = csr_from_edges_checked(G.n, &E, 1, NULL);
+    edges_free(&E);
+    csr_free(&G);
+    return M;
+}
+
+static void bench_absorb(int n) {
+    printf("=== Absorption ===\n");
+    int small = n < 600 ? n : 600;
+    CsrGraph A = merge_duplicates(gen_islands(small, 8));
+    bench_absorb_one("ilots (petit)", &A, 1);
+    csr_free(&A);
+    CsrGraph B = merge_duplicates(gen_dag(small, 4));
+    bench_absorb_one("dag (petit)", &B, 1);
+    csr_free(&B);
+
+    CsrGraph C = gen_islands(n, 8);
+    bench_absorb_one("ilots", &C, 0);
+    csr_free(&C);
+    CsrGraph D = gen_dag(n, 4);
+    bench_absorb_one("dag", &D, 0);
+    csr_free(&D);
+}
+
+
+// ---------- Section blocs : matrice triangulaire par blocs contre dense ----------
+static double max_abs_diff(const Matrix *A, const Matrix *B) {
+    double d = 0.0;
+    for (int i = 0; i < A->n; ++i)
+        for (int j = 0; j < A->n; ++j) {
+            double e = fabs((double)MAT(A, i, j) - (double)MAT(B, i, j));
+            if (e > d) d = e;
+        }
+    return d;
+}
+
+static void bench_blocks_one(int n, int dense) {
+    CsrGraph G = merge_duplicates(gen_islands(n, 8));
+    TarjanPartition P = tarjan_run_csr(&G);
+    Classification K = classify_classes(&G, &P);
+    int period = classification_period(&K);
+
+    double t0 = now_sec();
+    BlockMatrix B = block_from_csr(&G, &P);
+    BlockMatrix B64 = block_pow(&B, 64);
+    double t1 = now_sec();
+    BlockLimitReport br;
+    BlockMatrix BL = block_limit(&B, &K, NULL, &br);
+    double t2 = now_sec();
+    printf("n=%d, %d classes, periode %d : %lld blocs (%lld valeurs, n^2 = %lld)\n", n, P.size, period,
+           (long long)B.nnzb, (long long)B.boff[B.nnzb], (long long)n * n);
+    printf("  blocs  M^64 %.3f s (%lld blocs)   limite %.3f s (%d/%d classes fermees convergees%s)\n",
+           t1 - t0, (long long)B64.nnzb, t2 - t1, br.converged_blocks, br.closed_blocks,
+           br.unordered ? ", blocs non ordonnes" : br.singular_blocks ? ", blocs singuliers" : "");
+
+    if (dense) {
+        double t3 = now_sec();
+        Matrix M = matrix_from_csr(&G);
+        Matrix M64 = matrix_pow(&M, 64);
+        double t4 = now_sec();
+        MatrixLimitReport lr;
+        Matrix L = matrix_limit(&M, period, NULL, &lr);
+        double t5 = now_sec();
+        Matrix X64 = block_to_matrix(&B64);
+        Matrix XL = block_to_matrix(&BL);
+        printf("  dense  M^64 %.3f s (ecart %.1e)   limite %.3f s (%d produits, ecart %.1e)\n",
+               t4 - t3, max_abs_diff(&M64, &X64), t5 - t4, lr.iterations + 1, max_abs_diff(&L, &XL));
+        matrix_free(&XL);
+        matrix_free(&X64);
+        matrix_free(&L);
+        matrix_free(&M64);
+        matrix_free(&M);
+    }
+
+    block_free(&BL);
+    block_free(&B64);
+    block_free(&B);
+    classification_free(&K);
+    partition_free(&P);
+    csr_free(&G);
+}
+
+static void bench_blocks(int n) {
+    printf("=== Matrice par blocs ===\n");
+    bench_blocks_one(n < 1000 ? n : 1000, 1);
+    if (n > 1000) bench_blocks_one(n < 20000 ? n : 20000, 0);
+}
+
+
+// ---------- Section convergence : pilote fusionné contre copie + matrix_diff ----------
+static void bench_converge(int n) {
+    CsrGraph G = merge_duplicates(gen_islands(n, 8));
+    Matrix M = matrix_from_csr(&G);
+    int reps = 10;
+    printf("=== Convergence de M^n n=%d (noyau %s) ===\n", n, matrix_kernel_name());
+
+    // coût d'une itération hors produit : avec A = M (creuse) le produit
+    // est bon marché et les passages supplémentaires sur n^2 valeurs pèsent
+    Matrix A = matrix_create(n), B = matrix_create(n);
+    acc_t *row_l1 = (acc_t*)malloc((size_t)n * sizeof(acc_t));
+    acc_t *row_max = (acc_t*)malloc((size_t)n * sizeof(acc_t));
+    // meilleur de 5 tours, les trois variantes alternées (machine bruitée)
+    acc_t d = 0, f = 0;
+    double best[3] = { 1e30, 1e30, 1e30 };
+    for (int round = 0; round < 5; ++round) {
+        double t0 = now_sec();
+        for (int r = 0; r < reps; ++r) matrix_mult(&M, &M, &B);
+        double t1 = now_sec();
+        for (int r = 0; r < reps; ++r) {
+            matrix_mult(&M, &M, &B);
+            d = matrix_diff(&M, &B);
+            matrix_copy(&A, &B);
+        }
+        double t2 = now_sec();
+        for (int r = 0; r < reps; ++r) {
+            matrix_mult_diff(&M, &M, &B, &M, row_l1, row_max);
+            f = 0;
+            for (int i = 0; i < n; ++i) f += row_l1[i];
+        }
+        double t3 = now_sec();
+        if (t1 - t0 < best[0]) best[0] = t1 - t0;
+        if (t2 - t1 < best[1]) best[1] = t2 - t1;
+        if (t3 - t2 < best[2]) best[2] = t3 - t2;
+    }
+    printf("produit seul %.2f ms   + diff + copie %.2f ms   produit fusionne %.2f ms  (diff %.4f / %.4f)\n",
+           1e3 * best[0] / reps, 1e3 * best[1] / reps, 1e3 * best[2] / reps, d, f);
+    free(row_l1);
+    free(row_max);
+
+    matrix_free(&A);
+    matrix_free(&B);
+    matrix_free(&M);
+    csr_free(&G);
+
+    // critères d'arrêt sur M^period, chaîne plus petite
+    CsrGraph H = merge_duplicates(gen_islands(n < 400 ? n : 400, 8));
+    TarjanPartition P = tarjan_run_csr(&H);
+    Classification K = classify_classes(&H, &P);
+    int period = classification_period(&K);
+    Matrix MH = matrix_from_csr(&H);
+    Matrix Q = matrix_pow(&MH, period > 0 ? period : 1);
+    static const char *names[] = { "L1", "Linf", "ligne" };
+    for (int norm = CONV_L1; norm <= CONV_ROW; ++norm)
+        for (int every = 1; every <= 8; every *= 8) {
+            ConvergenceOptions opt = convergence_default_options();
+            opt.norm = (ConvergenceNorm)norm;
+            opt.tol = 1e-3f;
+            opt.check_every = every;
+            ConvergenceReport R;
+            double t0 = now_sec();
+            Matrix X = matrix_converge(&Q, &Q, &opt, &R);
+            double t1 = now_sec();
+            printf("n=%d critere %-5s / %d (tol 1e-3) : %.3f s, %d iterations%s, %d mesures, ligne la plus lente %d\n",
+                   H.n, names[norm], every, t1 - t0, R.iterations, R.converged ? "" : " (non convergee)",
+                   R.checks, R.worst_row + 1);
+            matrix_free(&X);
+        }
+
+    matrix_free(&Q);
+    matrix_free(&MH);
+    classification_free(&K);
+    partition_free(&P);
+    csr_free(&H);
+}
+
+
+int main(int argc, char **argv) {
+    const char *section = (argc > 1) ? argv[1] : "all";
+    int n = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (n < 1) n = 1;
+
+    int all = (strcmp(section, "all") == 0);
+    if (all || strcmp(section, "scc") == 0) bench_scc(n);
+    if (all || strcmp(section, "mult") == 0) bench_mult(n < 2000 ? n : 2000);
+    if (all || strcmp(section, "stationary") == 0) bench_stationary(n);
+    if (all || strcmp(section, "limit") == 0) bench_limit(n);
+    if (all || strcmp(section, "links") == 0) bench_links(n);
+    if (all || strcmp(section, "hasse") == 0) bench_hasse(n);
+    if (all || strcmp(section, "reach") == 0) bench_reach(n);
+    if (all || strcmp(section, "alloc") == 0) bench_alloc(n);
+    if (all || strcmp(section, "precision") == 0) bench_precision(n < 1000 ? n : 1000);
+    if (all || strcmp(section, "dynscc") == 0) bench_dynscc(n);
+    if (all || strcmp(section, "stream") == 0) bench_stream(n);
+    if (all || strcmp(section, "validate") == 0) bench_validate(n);
+    if (all || strcmp(section, "batch") == 0) bench_batch(n);
+    if (all || strcmp(section, "mermaid") == 0) bench_mermaid(n);
+    if (all || strcmp(section, "classify") == 0) bench_classify(n);
+    if (all || strcmp(section, "absorb") == 0) bench_absorb(n);
+    if (all || strcmp(section, "blocks") == 0) bench_blocks(n);
+    if (all || strcmp(section, "converge") == 0) bench_converge(n < 2000 ? n : 2000);
+
+    return 0;
+}
@@ -0,0 +1,578 @@
+#include "blockmatrix.h"
+#include <string.h>
+#include <math.h>
+
+static int block_size(const BlockMatrix *A, int b) {
+    return A->start[b + 1] - A->start[b];
+}
+
+static void *block_malloc(size_t bytes) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        perror("malloc block matrix");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Nouvelle matrice découpée comme L, avec les blocs (brow, bcol) à zéro.
+// brow et bcol appartiennent ensuite à la matrice.
+static BlockMatrix block_alloc(const BlockMatrix *L, int64_t *brow, int *bcol) {
+    BlockMatrix A;
+    A.n = L->n;
+    A.nblocks = L->nblocks;
+    A.ordered = L->ordered;
+    A.perm = (int*)block_malloc((size_t)A.n * sizeof(int));
+    A.start = (int*)block_malloc(((size_t)A.nblocks + 1) * sizeof(int));
+    A.bclass = (int*)block_malloc((size_t)A.nblocks * sizeof(int));
+    memcpy(A.perm, L->perm, (size_t)A.n * sizeof(int));
+    memcpy(A.start, L->start, ((size_t)A.nblocks + 1) * sizeof(int));
+    memcpy(A.bclass, L->bclass, (size_t)A.nblocks * sizeof(int));
+    A.brow = brow;
+    A.bcol = bcol;
+    A.nnzb = brow[A.nblocks];
+
+    A.boff = (int64_t*)block_malloc(((size_t)A.nnzb + 1) * sizeof(int64_t));
+    A.boff[0] = 0;
+    for (int b = 0; b < A.nblocks; ++b)
+        for (int64_t q = brow[b]; q < brow[b + 1]; ++q)
+            A.boff[q + 1] = A.boff[q] + (int64_t)block_size(&A, b) * block_size(&A, bcol[q]);
+    A.data = (prob_t*)calloc(A.boff[A.nnzb] > 0 ? (size_t)A.boff[A.nnzb] : 1, sizeof(prob_t));
+    if (!A.data) {
+        perror("malloc block matrix");
+        exit(EXIT_FAILURE);
+    }
+    return A;
+}
+
+static BlockMatrix block_copy(const BlockMatrix *A) {
+    int64_t *brow = (int64_t*)block_malloc(((size_t)A->nblocks + 1) * sizeof(int64_t));
+    int *bcol = (int*)block_malloc((size_t)A->nnzb * sizeof(int));
+    memcpy(brow, A->brow, ((size_t)A->nblocks + 1) * sizeof(int64_t));
+    memcpy(bcol, A->bcol, (size_t)A->nnzb * sizeof(int));
+    BlockMatrix C = block_alloc(A, brow, bcol);
+    memcpy(C.data, A->data, (size_t)A->boff[A->nnzb] * sizeof(prob_t));
+    return C;
+}
+
+static BlockMatrix block_identity(const BlockMatrix *A) {
+    int64_t *brow = (int64_t*)block_malloc(((size_t)A->nblocks + 1) * sizeof(int64_t));
+    int *bcol = (int*)block_malloc((size_t)A->nblocks * sizeof(int));
+    for (int b = 0; b <= A->nblocks; ++b) brow[b] = b;
+    for (int b = 0; b < A->nblocks; ++b) bcol[b] = b;
+    BlockMatrix I = block_alloc(A, brow, bcol);
+    for (int b = 0; b < I.nblocks; ++b) {
+        int s = block_size(&I, b);
+        for (int i = 0; i < s; ++i) I.data[I.boff[b] + (int64_t)i * s + i] = 1;
+    }
+    return I;
+}
+
+
+// ---------- Motif des blocs non nuls ----------
+// Colonnes de blocs ligne par ligne, dans un tableau qui double
+typedef struct {
+    int     *data;
+    int64_t  size;
+    int64_t  capacity;
+} ColList;
+
+static void col_push(ColList *C, int j) {
+    if (C->size == C->capacity) {
+        int64_t nc = C->capacity < 8 ? 8 : C->capacity * 2;
+        int *nd = (int*)realloc(C->data, (size_t)nc * sizeof(int));
+        if (!nd) {
+            perror("realloc block pattern");
+            exit(EXIT_FAILURE);
+        }
+        C->data = nd;
+        C->capacity = nc;
+    }
+    C->data[C->size++] = j;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Trie la ligne qui vient d’être ajoutée et ferme brow[b + 1]
+static void close_row(ColList *C, int64_t *brow, int b) {
+    int64_t first = brow[b];
+    if (C->size - first > 1)
+        qsort(C->data + first, (size_t)(C->size - first), sizeof(int), cmp_int);
+    brow[b + 1] = C->size;
+}
+
+// Index de chaque bloc de la ligne b dans slot[colonne]
+static void row_slots(const BlockMatrix *A, int b, int64_t *slot) {
+    for (int64_t q = A->brow[b]; q < A->brow[b + 1]; ++q) slot[A->bcol[q]] = q;
+}
+
+
+// ---------- Construction ----------
+// Range les états bloc par bloc, le bloc b recevant la classe L->bclass[b]
+static void place_blocks(BlockMatrix *L, const TarjanPartition *P, int *pos, int *blk) {
+    int p = 0;
+    for (int b = 0; b < L->nblocks; ++b) {
+        const TarjanClass *C = &P->classes[L->bclass[b]];
+        L->start[b] = p;
+        for (int k = 0; k < C->size; ++k) {
+            int v = C->members[k];
+            pos[v] = p;
+            blk[v] = b;
+            L->perm[p++] = v;
+        }
+    }
+    L->start[L->nblocks] = p;
+}
+
+// Motif : blocs atteints par les arcs de chaque ligne de blocs.
+// Rend 0 si un arc va vers un bloc précédent (bcol < b).
+static int block_pattern(const CsrGraph *G, const BlockMatrix *L, const int *blk, int *mark,
+                         ColList *cols, int64_t *brow) {
+    int ordered = 1;
+    for (int b = 0; b < L->nblocks; ++b) mark[b] = -1;
+    cols->size = 0;
+    brow[0] = 0;
+    for (int b = 0; b < L->nblocks; ++b) {
+        for (int i = L->start[b]; i < L->start[b + 1]; ++i) {
+            int u = L->perm[i];
+            for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e) {
+                int j = blk[G->dest[e]];
+                if (mark[j] != b) {
+                    mark[j] = b;
+                    col_push(cols, j);
+                    if (j < b) ordered = 0;
+                }
+            }
+        }
+        close_row(cols, brow, b);
+    }
+    return ordered;
+}
+
+/* Ordre topologique des blocs (Kahn, sources d’abord) d’après le motif :
+   bclass[b] est remplacé par la classe du b-ième bloc de cet ordre.
+   Rend 0, sans rien changer, si les blocs forment un cycle (P n’est pas
+   une partition en composantes fortement connexes). */
+static int topo_blocks(BlockMatrix *L, const ColList *cols, const int64_t *brow) {
+    int nb = L->nblocks;
+    int *indeg = (int*)calloc((size_t)nb > 0 ? nb : 1, sizeof(int));
+    int *queue = (int*)block_malloc((size_t)nb * sizeof(int));
+    if (!indeg) {
+        perror("malloc block order");
+        exit(EXIT_FAILURE);
+    }
+    for (int b = 0; b < nb; ++b)
+        for (int64_t q = brow[b]; q < brow[b + 1]; ++q)
+            if (cols->data[q] != b) indeg[cols->data[q]]++;
+
+    int head = 0, tail = 0;
+    for (int b = 0; b < nb; ++b)
+        if (indeg[b] == 0) queue[tail++] = b;
+    while (head < tail) {
+        int b = queue[head++];
+        for (int64_t q = brow[b]; q < brow[b + 1]; ++q) {
+            int j = cols->data[q];
+            if (j != b && --indeg[j] == 0) queue[tail++] = j;
+        }
+    }
+
+    int ok = (tail == nb);
+    if (ok) {
+        // indeg ne sert plus : il garde l’ancienne classe de chaque bloc
+        for (int b = 0; b < nb; ++b) indeg[b] = L->bclass[b];
+        for (int b = 0; b < nb; ++b) L->bclass[b] = indeg[queue[b]];
+    }
+    free(queue);
+    free(indeg);
+    return ok;
+}
+
+BlockMatrix block_from_csr(const CsrGraph *G, const TarjanPartition *P) {
+    BlockMatrix L;   // découpage seul, pour block_alloc
+    int n = G->n, nb = P->size;
+    L.n = n;
+    L.nblocks = nb;
+    L.perm = (int*)block_malloc((size_t)n * sizeof(int));
+    L.start = (int*)block_malloc(((size_t)nb + 1) * sizeof(int));
+    L.bclass = (int*)block_malloc((size_t)nb * sizeof(int));
+    int *pos = (int*)block_malloc(((size_t)n + 1) * sizeof(int));
+    int *blk = (int*)block_malloc(((size_t)n + 1) * sizeof(int));
+
+    // bloc b = classe nb-1-b : les puits de Tarjan passent à la fin
+    for (int b = 0; b < nb; ++b) L.bclass[b] = nb - 1 - b;
+    place_blocks(&L, P, pos, blk);
+
+    int64_t *brow = (int64_t*)block_malloc(((size_t)nb + 1) * sizeof(int64_t));
+    int *mark = (int*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int));
+    ColList cols = { NULL, 0, 0 };
+    L.ordered = block_pattern(G, &L, blk, mark, &cols, brow);
+
+    // P n’est pas puits d’abord : blocs remis dans un ordre topologique
+    if (!L.ordered && topo_blocks(&L, &cols, brow)) {
+        place_blocks(&L, P, pos, blk);
+        L.ordered = block_pattern(G, &L, blk, mark, &cols, brow);
+    }
+
+    BlockMatrix A = block_alloc(&L, brow, cols.data ? cols.data : (int*)block_malloc(sizeof(int)));
+    free(L.perm);
+    free(L.start);
+    free(L.bclass);
+
+    // remplissage (comme matrix_from_csr : un arc répété garde la dernière valeur)
+    int64_t *slot = (int64_t*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int64_t));
+    for (int b = 0; b < nb; ++b) {
+        row_slots(&A, b, slot);
+        for (int i = A.start[b]; i < A.start[b + 1]; ++i) {
+            int u = A.perm[i];
+            for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e) {
+                int v = G->dest[e], j = blk[v];
+                prob_t *B = A.data + A.boff[slot[j]];
+                B[(int64_t)(i - A.start[b]) * block_size(&A, j) + (pos[v] - A.start[j])] = G->prob[e];
+            }
+        }
+    }
+
+    free(slot);
+    free(mark);
+    free(blk);
+    free(pos);
+    return A;
+}
+
+Matrix block_to_matrix(const BlockMatrix *A) {
+    Matrix M = matrix_create(A->n);
+    for (int b = 0; b < A->nblocks; ++b) {
+        int s = block_size(A, b);
+        for (int64_t q = A->brow[b]; q < A->brow[b + 1]; ++q) {
+            int j = A->bcol[q], c = block_size(A, j);
+            const prob_t *B = A->data + A->boff[q];
+            for (int i = 0; i < s; ++i)
+                for (int k = 0; k < c; ++k)
+                    MAT(&M, A->perm[A->start[b] + i] - 1, A->perm[A->start[j] + k] - 1) = B[(int64_t)i * c + k];
+        }
+    }
+    return M;
+}
+
+void block_free(BlockMatrix *A) {
+    if (!A) return;
+    free(A->perm);
+    free(A->start);
+    free(A->bclass);
+    free(A->brow);
+    free(A->bcol);
+    free(A->boff);
+    free(A->data);
+    memset(A, 0, sizeof(*A));
+}
+
+
+// ---------- Produit ----------
+// out (r × c) += a (r × s) × b (s × c), zéros de a sautés. out est en
+// acc_t : arrondi en prob_t une seule fois, à la fin de la ligne de blocs
+static void gemm_add(const prob_t *a, int r, int s, const prob_t *b, int c, acc_t *out) {
+    for (int i = 0; i < r; ++i) {
+        acc_t *o = out + (int64_t)i * c;
+        for (int k = 0; k < s; ++k) {
+            acc_t x = a[(int64_t)i * s + k];
+            if (x == 0) continue;
+            const prob_t *bk = b + (int64_t)k * c;
+            for (int j = 0; j < c; ++j) o[j] += x * bk[j];
+        }
+    }
+}
+
+BlockMatrix block_mult(const BlockMatrix *A, const BlockMatrix *B) {
+    int nb = A->nblocks;
+    int64_t *brow = (int64_t*)block_malloc(((size_t)nb + 1) * sizeof(int64_t));
+    int *mark = (int*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int));
+    int64_t *slot = (int64_t*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int64_t));
+    for (int b = 0; b < nb; ++b) mark[b] = -1;
+
+    // motif de A × B : blocs (b, j) avec un k tel que A_bk et B_kj non nuls
+    ColList cols = { NULL, 0, 0 };
+    brow[0] = 0;
+    for (int b = 0; b < nb; ++b) {
+        for (int64_t qa = A->brow[b]; qa < A->brow[b + 1]; ++qa) {
+            int k = A->bcol[qa];
+            for (int64_t qb = B->brow[k]; qb < B->brow[k + 1]; ++qb) {
+                int j = B->bcol[qb];
+                if (mark[j] != b) {
+                    mark[j] = b;
+                    col_push(&cols, j);
+                }
+            }
+        }
+        close_row(&cols, brow, b);
+    }
+    BlockMatrix R = block_alloc(A, brow, cols.data ? cols.data : (int*)block_malloc(sizeof(int)));
+
+    // ligne de blocs b sommée dans acc (rangée comme R), puis rangée en prob_t
+    acc_t *acc = NULL;
+    int64_t acc_capacity = 0;
+    for (int b = 0; b < nb; ++b) {
+        int64_t first = R.boff[R.brow[b]], total = R.boff[R.brow[b + 1]] - first;
+        if (total == 0) continue;
+        if (total > acc_capacity) {
+            acc_t *na = (acc_t*)realloc(acc, (size_t)total * sizeof(acc_t));
+            if (!na) {
+                perror("realloc block product");
+                exit(EXIT_FAILURE);
+            }
+            acc = na;
+            acc_capacity = total;
+        }
+        for (int64_t i = 0; i < total; ++i) acc[i] = 0;
+
+        row_slots(&R, b, slot);
+        int r = block_size(A, b);
+        for (int64_t qa = A->brow[b]; qa < A->brow[b + 1]; ++qa) {
+            int k = A->bcol[qa], s = block_size(A, k);
+            for (int64_t qb = B->brow[k]; qb < B->brow[k + 1]; ++qb) {
+                int j = B->bcol[qb];
+                gemm_add(A->data + A->boff[qa], r, s, B->data + B->boff[qb], block_size(B, j),
+                         acc + (R.boff[slot[j]] - first));
+            }
+        }
+        for (int64_t i = 0; i < total; ++i) R.data[first + i] = (prob_t)acc[i];
+    }
+
+    free(acc);
+    free(slot);
+    free(mark);
+    return R;
+}
+
+BlockMatrix block_pow(const BlockMatrix *A, int k) {
+    if (k <= 0) return block_identity(A);
+
+    BlockMatrix base = block_copy(A);
+    BlockMatrix result;
+    int has_result = 0;   // tant que 0, result vaut l’identité
+    while (k > 0) {
+        if (k & 1) {
+            if (has_result) {
+                BlockMatrix t = block_mult(&result, &base);
+                block_free(&result);
+                result = t;
+            } else {
+                result = block_copy(&base);
+                has_result = 1;
+            }
+        }
+        k >>= 1;
+        if (k > 0) {
+            BlockMatrix t = block_mult(&base, &base);
+            block_free(&base);
+            base = t;
+        }
+    }
+    block_free(&base);
+    return result;
+}
+
+
+// ---------- Limite ----------
+// Factorisation LU de F (s × s) avec pivot partiel ; 0 si singulière
+static int lu_factor(double *F, int s, int *piv) {
+    for (int k = 0; k < s; ++k) {
+        int p = k;
+        for (int i = k + 1; i < s; ++i)
+            if (fabs(F[(int64_t)i * s + k]) > fabs(F[(int64_t)p * s + k])) p = i;
+        piv[k] = p;
+        if (fabs(F[(int64_t)p * s + k]) < 1e-12) return 0;
+        if (p != k)
+            for (int j = 0; j < s; ++j) {
+                double t = F[(int64_t)k * s + j];
+                F[(int64_t)k * s + j] = F[(int64_t)p * s + j];
+                F[(int64_t)p * s + j] = t;
+            }
+        for (int i = k + 1; i < s; ++i) {
+            double f = F[(int64_t)i * s + k] /= F[(int64_t)k * s + k];
+            if (f == 0.0) continue;
+            for (int j = k + 1; j < s; ++j) F[(int64_t)i * s + j] -= f * F[(int64_t)k * s + j];
+        }
+    }
+    return 1;
+}
+
+// Résout F X = B en place (X contient B en entrée, la solution en sortie),
+// X de s lignes et c colonnes
+static void lu_solve(const double *F, int s, const int *piv, double *X, int c) {
+    for (int k = 0; k < s; ++k)
+        if (piv[k] != k)
+            for (int j = 0; j < c; ++j) {
+                double t = X[(int64_t)k * c + j];
+                X[(int64_t)k * c + j] = X[(int64_t)piv[k] * c + j];
+                X[(int64_t)piv[k] * c + j] = t;
+            }
+    for (int i = 1; i < s; ++i)
+        for (int k = 0; k < i; ++k) {
+            double f = F[(int64_t)i * s + k];
+            if (f == 0.0) continue;
+            for (int j = 0; j < c; ++j) X[(int64_t)i * c + j] -= f * X[(int64_t)k * c + j];
+        }
+    for (int i = s - 1; i >= 0; --i) {
+        for (int k = i + 1; k < s; ++k) {
+            double f = F[(int64_t)i * s + k];
+            if (f == 0.0) continue;
+            for (int j = 0; j < c; ++j) X[(int64_t)i * c + j] -= f * X[(int64_t)k * c + j];
+        }
+        for (int j = 0; j < c; ++j) X[(int64_t)i * c + j] /= F[(int64_t)i * s + i];
+    }
+}
+
+BlockMatrix block_limit(const BlockMatrix *A, const Classification *K, const ConvergenceOptions *opt,
+                        BlockLimitReport *rep) {
+    BlockLimitReport R = { 0, 0, 0, 0, 0 };
+    int nb = A->nblocks;
+
+    // la remontée depuis les puits suppose des blocs triangulaires supérieurs
+    if (!A->ordered) {
+        R.unordered = 1;
+        if (rep) *rep = R;
+        int64_t *brow = (int64_t*)calloc((size_t)nb + 1, sizeof(int64_t));
+        if (!brow) {
+            perror("malloc block limit");
+            exit(EXIT_FAILURE);
+        }
+        return block_alloc(A, brow, (int*)block_malloc(sizeof(int)));
+    }
+
+    int *mark = (int*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int));
+    int64_t *slot = (int64_t*)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int64_t));
+    for (int b = 0; b < nb; ++b) mark[b] = -1;
+
+    /* Motif de la limite, des puits vers les sources : une classe fermée
+       ne garde que son bloc diagonal, une transitoire reçoit l’union des
+       classes fermées atteintes par ses successeurs. Les lignes sont
+       calculées dans l’ordre inverse, rangées puis mises à plat. */
+    int **rows = (int**)block_malloc(((size_t)nb > 0 ? nb : 1) * sizeof(int*));
+    int *count = (int*)calloc((size_t)nb > 0 ? nb : 1, sizeof(int));
+    if (!count) {
+        perror("malloc block limit");
+        exit(EXIT_FAILURE);
+    }
+    ColList buf = { NULL, 0, 0 };
+    for (int b = nb - 1; b >= 0; --b) {
+        buf.size = 0;
+        if (K->persistent[A->bclass[b]]) {
+            col_push(&buf, b);
+        } else {
+            for (int64_t q = A->brow[b]; q < A->brow[b + 1]; ++q) {
+                int k = A->bcol[q];
+                if (k == b) continue;
+                for (int t = 0; t < count[k]; ++t) {
+                    int j = rows[k][t];
+                    if (mark[j] != b) {
+                        mark[j] = b;
+                        col_push(&buf, j);
+                    }
+                }
+            }
+            if (buf.size > 1) qsort(buf.data, (size_t)buf.size, sizeof(int), cmp_int);
+        }
+        count[b] = (int)buf.size;
+        rows[b] = (int*)block_malloc((size_t)buf.size * sizeof(int));
+        if (buf.size) memcpy(rows[b], buf.data, (size_t)buf.size * sizeof(int));
+    }
+    free(buf.data);
+
+    int64_t *brow = (int64_t*)block_malloc(((size_t)nb + 1) * sizeof(int64_t));
+    brow[0] = 0;
+    for (int b = 0; b < nb; ++b) brow[b + 1] = brow[b] + count[b];
+    int *bcol = (int*)block_malloc((size_t)brow[nb] * sizeof(int));
+    for (int b = 0; b < nb; ++b) {
+        if (count[b]) memcpy(bcol + brow[b], rows[b], (size_t)count[b] * sizeof(int));
+        free(rows[b]);
+    }
+    free(rows);
+    free(count);
+    BlockMatrix L = block_alloc(A, brow, bcol);
+
+    double *F = NULL, *X = NULL;
+    int *piv = NULL;
+    for (int b = nb - 1; b >= 0; --b) {
+        int c = A->bclass[b], s = block_size(A, b);
+        int64_t diag = -1;
+        for (int64_t q = A->brow[b]; q < A->brow[b + 1]; ++q)
+            if (A->bcol[q] == b) diag = q;
+
+        if (K->persistent[c]) {
+            // classe fermée : limite de son seul bloc diagonal
+            Matrix D = matrix_create(s);
+            if (diag >= 0)
+                for (int i = 0; i < s; ++i)
+                    memcpy(&MAT(&D, i, 0), A->data + A->boff[diag] + (int64_t)i * s, s * sizeof(prob_t));
+            MatrixLimitReport mr;
+            Matrix Dl = matrix_limit(&D, K->period[c] > 1 ? K->period[c] : 1, opt, &mr);
+            prob_t *out = L.data + L.boff[L.brow[b]];
+            for (int i = 0; i < s; ++i) memcpy(out + (int64_t)i * s, &MAT(&Dl, i, 0), s * sizeof(prob_t));
+            R.closed_blocks++;
+            R.converged_blocks += mr.converged;
+            if (mr.iterations > R.max_iterations) R.max_iterations = mr.iterations;
+            matrix_free(&Dl);
+            matrix_free(&D);
+            continue;
+        }
+
+        // classe transitoire : X_b = (I - A_bb)^-1 * somme des A_bk X_k
+        int64_t first = L.boff[L.brow[b]], total = L.boff[L.brow[b + 1]] - first;
+        if (total == 0) continue;
+        double *nX = (double*)realloc(X, (size_t)total * sizeof(double));
+        double *nF = (double*)realloc(F, (size_t)s * s * sizeof(double));
+        int *np = (int*)realloc(piv, (size_t)s * sizeof(int));
+        if (!nX || !nF || !np) {
+            perror("realloc block limit");
+            exit(EXIT_FAILURE);
+        }
+        X = nX;
+        F = nF;
+        piv = np;
+        for (int64_t i = 0; i < total; ++i) X[i] = 0.0;
+
+        // second membre, rangé comme les blocs de la ligne b de L
+        row_slots(&L, b, slot);
+        for (int64_t qa = A->brow[b]; qa < A->brow[b + 1]; ++qa) {
+            int k = A->bcol[qa], sk = block_size(A, k);
+            if (k == b) continue;
+            const prob_t *a = A->data + A->boff[qa];
+            for (int64_t ql = L.brow[k]; ql < L.brow[k + 1]; ++ql) {
+                int j = L.bcol[ql], cj = block_size(A, j);
+                const prob_t *x = L.data + L.boff[ql];
+                double *out = X + (L.boff[slot[j]] - first);
+                for (int i = 0; i < s; ++i)
+                    for (int t = 0; t < sk; ++t) {
+                        double f = a[(int64_t)i * sk + t];
+                        if (f == 0.0) continue;
+                        for (int v = 0; v < cj; ++v) out[(int64_t)i * cj + v] += f * x[(int64_t)t * cj + v];
+                    }
+            }
+        }
+
+        for (int i = 0; i < s; ++i)
+            for (int j = 0; j < s; ++j)
+                F[(int64_t)i * s + j] = (i == j) - (diag >= 0 ? (double)A->data[A->boff[diag] + (int64_t)i * s + j] : 0.0);
+        if (!lu_factor(F, s, piv)) {
+            R.singular_blocks++;
+            continue;   // ligne laissée à zéro
+        }
+        for (int64_t q = L.brow[b]; q < L.brow[b + 1]; ++q) {
+            int cj = block_size(A, L.bcol[q]);
+            double *x = X + (L.boff[q] - first);
+            lu_solve(F, s, piv, x, cj);
+            for (int64_t i = 0; i < (int64_t)s * cj; ++i) L.data[L.boff[q] + i] = (prob_t)x[i];
+        }
+    }
+
+    free(X);
+    free(F);
+    free(piv);
+    free(slot);
+    free(mark);
+    if (rep) *rep = R;
+    return L;
+}
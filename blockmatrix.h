@@ -0,0 +1,81 @@
+#ifndef BLOCKMATRIX_H
+#define BLOCKMATRIX_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+#include "caracteristiques.h"
+
+/*
+   Matrice de transition par blocs de classes.
+
+   Les états sont permutés classe par classe, dans l’ordre inverse de
+   Tarjan (classes sources d’abord, puits à la fin) : un arc ne va jamais
+   d’un bloc vers un bloc précédent et la matrice est triangulaire
+   supérieure par blocs. Si la partition n’est pas rangée puits d’abord,
+   les blocs sont remis dans un ordre topologique des classes. Seuls les blocs non nuls sont gardés, rangés
+   comme un CSR de blocs ; chaque bloc est une petite matrice dense
+   taille(ligne) × taille(colonne), ligne par ligne.
+
+   Un produit ne touche que les paires de blocs non nuls : le coût dépend
+   des tailles des classes et des liens entre elles, plus de n^3.
+*/
+typedef struct {
+    int      n;          // états
+    int      nblocks;    // blocs diagonaux (= classes)
+    int     *perm;       // perm[i] : sommet (1..n) à la position i
+    int     *start;      // nblocks+1 : positions du bloc b = start[b] .. start[b+1]-1
+    int     *bclass;     // nblocks : indice dans P de la classe du bloc b
+    int      ordered;    // 1 : aucun bloc non nul sous la diagonale (bcol >= b)
+    int64_t *brow;       // nblocks+1 : blocs non nuls de la ligne de blocs b
+    int     *bcol;       // colonne de chaque bloc non nul (croissantes, >= b si ordered)
+    int64_t *boff;       // nnzb+1 : début de chaque bloc dans data
+    prob_t  *data;       // blocs denses, l’un après l’autre
+    int64_t  nnzb;       // blocs non nuls
+} BlockMatrix;
+
+/*
+   Bloc b de la classe P->classes[bclass[b]] : nblocks-1-b si P est puits
+   d’abord (sortie de Tarjan). Sinon (arc vers un bloc précédent vu en
+   construisant le motif), ordre topologique des classes ; si les classes
+   forment un cycle, P n’est pas une partition en composantes fortement
+   connexes et ordered vaut 0.
+*/
+BlockMatrix block_from_csr(const CsrGraph *G, const TarjanPartition *P);
+
+// R = A × B (même découpage). À libérer par block_free.
+BlockMatrix block_mult(const BlockMatrix *A, const BlockMatrix *B);
+
+// A^k par exponentiation rapide, k >= 0
+BlockMatrix block_pow(const BlockMatrix *A, int k);
+
+// Bilan de block_limit
+typedef struct {
+    int closed_blocks;     // classes fermées
+    int converged_blocks;  // dont le bloc diagonal a convergé
+    int max_iterations;    // plus grand nombre d’itérations d’un bloc fermé
+    int singular_blocks;   // blocs transitoires où I - A_bb n’est pas inversible
+    int unordered;         // 1 : A n’est pas triangulaire par blocs, limite refusée
+} BlockLimitReport;
+
+/*
+   Limite de A^n (au sens de Cesàro si une classe est périodique), bloc
+   par bloc :
+   - bloc diagonal d’une classe fermée : matrix_limit sur ce seul bloc (opt, NULL :
+     options par défaut), avec la période de la classe (K->period) ;
+   - ligne d’une classe transitoire b, en remontant depuis les puits :
+     X_b = (I - A_bb)^-1 * somme des A_bk X_k (k > b), les X_k étant déjà
+     connues. Une élimination par classe transitoire, aucune itération.
+   Les blocs diagonaux transitoires de la limite sont nuls.
+   Refusée si A->ordered vaut 0 : rep->unordered = 1 et matrice sans bloc.
+*/
+BlockMatrix block_limit(const BlockMatrix *A, const Classification *K, const ConvergenceOptions *opt,
+                        BlockLimitReport *rep);
+
+// Matrice dense n×n dans l’ordre d’origine des sommets
+Matrix block_to_matrix(const BlockMatrix *A);
+
+void block_free(BlockMatrix *A);
+
+#endif // BLOCKMATRIX_H
@@ -1,21 +1,134 @@
 #include "caracteristiques.h"
+#include <limits.h>
 
-void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L) {
+// ---------- Période des classes ----------
+static int gcd(int a, int b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
 
-    printf("\n=== Etape 3 : Caracteristiques du graphe ===\n");
+int *class_periods(const CsrGraph *G, const TarjanPartition *P, const int *class_of) {
+    int n = G->n;
+    int *period = (int*)calloc(P->size > 0 ? P->size : 1, sizeof(int));
+    int *level = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    int *queue = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (!period || !level || !queue) {
+        perror("malloc class periods");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v <= n; ++v) level[v] = -1;
 
-    int nbClasses = P->size;
+    for (int c = 0; c < P->size; ++c) {
+        const TarjanClass *C = &P->classes[c];
+        if (C->size == 0) continue;
 
-    // Tableau indiquant si une classe a un lien sortant (=> transitoire)
-    int *hasOutgoing = calloc(nbClasses, sizeof(int));
+        // BFS depuis le premier membre : tous les membres sont atteints (SCC)
+        int head = 0, tail = 0, g = 0;
+        level[C->members[0]] = 0;
+        queue[tail++] = C->members[0];
+        while (head < tail) {
+            int u = queue[head++];
+            for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k) {
+                int v = G->dest[k];
+                if (class_of[v] != c) continue;
+                if (level[v] < 0) {
+                    level[v] = level[u] + 1;
+                    queue[tail++] = v;
+                } else {
+                    g = gcd(g, level[u] + 1 - level[v]);
+                }
+            }
+        }
+        period[c] = g;
+    }
 
-    // Parcours des liens pour marquer les classes qui pointent vers d'autres
-    for (int i = 0; i < L->size; ++i) {
-        int from = L->data[i].from - 1;   // index de la classe source
-        if (from >= 0 && from < nbClasses)
-            hasOutgoing[from] = 1;        // cette classe a un lien sortant
+    free(level);
+    free(queue);
+    return period;
+}
+
+
+// ---------- Classification ----------
+Classification classify_classes(const CsrGraph *G, const TarjanPartition *P) {
+    Classification K;
+    int C = P->size;
+    K.nclasses = C;
+    K.out_edges = (int64_t*)calloc(C > 0 ? C : 1, sizeof(int64_t));
+    K.persistent = (char*)malloc(C > 0 ? C : 1);
+    K.absorbing = (char*)malloc(C > 0 ? C : 1);
+    if (!K.out_edges || !K.persistent || !K.absorbing) {
+        perror("malloc classification");
+        exit(EXIT_FAILURE);
     }
 
+    int *class_of = build_vertex_to_class(P, G->n);
+
+    // une passe sur les arcs : arcs qui quittent leur classe
+    for (int u = 1; u <= G->n; ++u) {
+        int cu = class_of[u];
+        if (cu < 0) continue;
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k)
+            if (class_of[G->dest[k]] != cu) K.out_edges[cu]++;
+    }
+
+    K.period = class_periods(G, P, class_of);
+    free(class_of);
+
+    K.transient_count = K.persistent_count = K.absorbing_count = K.periodic_count = 0;
+    for (int c = 0; c < C; ++c) {
+        K.persistent[c] = (K.out_edges[c] == 0);
+        K.absorbing[c] = K.persistent[c] && P->classes[c].size == 1;
+        if (K.persistent[c]) {
+            K.persistent_count++;
+            if (K.period[c] > 1) K.periodic_count++;
+        } else {
+            K.transient_count++;
+        }
+        K.absorbing_count += K.absorbing[c];
+    }
+    K.irreducible = (C == 1);
+    return K;
+}
+
+int classification_period(const Classification *K) {
+    int64_t d = 1;
+    for (int c = 0; c < K->nclasses; ++c) {
+        int p = K->period[c];
+        if (!K->persistent[c] || p <= 1) continue;
+        d = d / gcd((int)d, p) * p;
+        if (d > INT_MAX) return 0;
+    }
+    return (int)d;
+}
+
+void classification_free(Classification *K) {
+    if (!K) return;
+    free(K->out_edges);
+    free(K->persistent);
+    free(K->absorbing);
+    free(K->period);
+    K->out_edges = NULL;
+    K->persistent = NULL;
+    K->absorbing = NULL;
+    K->period = NULL;
+    K->nclasses = 0;
+}
+
+
+// ---------- Affichage ----------
+// hasOutgoing[c] : la classe c a un lien sortant ; period peut être NULL
+static void print_characteristics(const TarjanPartition *P, const char *hasOutgoing,
+                                  const int *period) {
+    printf("\n=== Etape 3 : Caracteristiques du graphe ===\n");
+
+    int nbClasses = P->size;
+
     // Un graphe est irréductible s'il n’a qu’une seule classe
     int irreductible = (nbClasses == 1);
 
@@ -24,7 +137,7 @@ void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L)
     // Parcours de chaque classe
     for (int i = 0; i < nbClasses; ++i) {
 
-        TarjanClass *C = &P->classes[i];
+        const TarjanClass *C = &P->classes[i];
 
         // Si elle a un lien sortant → transitoire, sinon → persistante
         if (hasOutgoing[i]) {
@@ -44,6 +157,10 @@ void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L)
         if (!hasOutgoing[i] && C->size == 1) {
             printf(" → L etat %d est absorbant.\n", C->members[0]);
         }
+        // Classe persistante périodique : M^n ne converge pas sur elle
+        if (period && !hasOutgoing[i] && period[i] > 1) {
+            printf(" → Classe periodique de periode %d.\n", period[i]);
+        }
     }
 
     // Conclusion sur l’irréductibilité du graphe
@@ -51,6 +168,37 @@ void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L)
         printf("\nLe graphe de Markov est irreductible (une seule classe).\n");
     else
         printf("\nLe graphe de Markov n est pas irreductible.\n");
+}
+
+void printClassification(const TarjanPartition *P, const Classification *K) {
+    char *hasOutgoing = (char*)malloc(P->size > 0 ? P->size : 1);
+    if (!hasOutgoing) {
+        perror("malloc classes");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < P->size; ++c) hasOutgoing[c] = !K->persistent[c];
+    print_characteristics(P, hasOutgoing, K->period);
+    free(hasOutgoing);
+}
+
+void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L) {
+    int nbClasses = P->size;
+
+    // Tableau indiquant si une classe a un lien sortant (=> transitoire)
+    char *hasOutgoing = calloc(nbClasses > 0 ? nbClasses : 1, 1);
+    if (!hasOutgoing) {
+        perror("calloc classes");
+        exit(EXIT_FAILURE);
+    }
+
+    // Parcours des liens pour marquer les classes qui pointent vers d'autres
+    // (les liens de build_class_links sont indexés à partir de 0)
+    for (int i = 0; i < L->size; ++i) {
+        int from = L->data[i].from;       // index de la classe source
+        if (from >= 0 && from < nbClasses)
+            hasOutgoing[from] = 1;        // cette classe a un lien sortant
+    }
 
+    print_characteristics(P, hasOutgoing, NULL);
     free(hasOutgoing);
 }
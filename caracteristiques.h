@@ -1,10 +1,43 @@
 #ifndef CARACTERISTIQUES_H
 #define CARACTERISTIQUES_H
 
+#include "graph.h"
 #include "hasse.h"
 #include "tarjan.h"
 
+// Nature des classes, calculée en O(V + E) depuis les arcs et la classe de
+// chaque sommet (pas besoin du diagramme de Hasse)
+typedef struct {
+    int      nclasses;
+    int64_t *out_edges;    // arcs sortant de chaque classe (0 : persistante)
+    char    *persistent;   // 1 : classe fermée, 0 : transitoire
+    char    *absorbing;    // 1 : classe fermée réduite à un état
+    int     *period;       // pgcd des cycles internes (0 : aucun cycle)
+    int      transient_count;
+    int      persistent_count;
+    int      absorbing_count;
+    int      periodic_count;  // classes persistantes de période > 1
+    int      irreducible;     // une seule classe
+} Classification;
+
+Classification classify_classes(const CsrGraph *G, const TarjanPartition *P);
+void           classification_free(Classification *K);
+
+// Période de chaque classe : BFS limité à la classe depuis un sommet, puis
+// pgcd des écarts niveau(u) + 1 - niveau(v) sur les arcs internes u -> v.
+// Tableau de P->size entrées, à libérer.
+int *class_periods(const CsrGraph *G, const TarjanPartition *P, const int *class_of);
+
+// Période de la chaîne : ppcm des périodes des classes persistantes
+// (1 : M^n converge ; d > 1 : seule la suite M^(kd) converge).
+// 0 si le ppcm dépasse INT_MAX.
+int classification_period(const Classification *K);
+
+// Affichage (format de printGraphCharacteristics)
+void printClassification(const TarjanPartition *P, const Classification *K);
+
 // Déclaration de la fonction d'affichage des caractéristiques
+// (à partir des liens entre classes, indices à partir de 0)
 void printGraphCharacteristics(const TarjanPartition *P, const t_link_array *L);
 
 #endif
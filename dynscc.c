@@ -0,0 +1,1017 @@
+#include "dynscc.h"
+#include <string.h>
+
+// ============================================================================
+//  Petits conteneurs
+// ============================================================================
+
+static void vec_push(IntVec *V, int x) {
+    if (V->size >= V->capacity) {
+        int nc = (V->capacity < 4) ? 4 : V->capacity * 2;
+        int *nd = (int*)realloc(V->data, nc * sizeof(int));
+        if (!nd) {
+            perror("realloc dynscc vector");
+            exit(EXIT_FAILURE);
+        }
+        V->data = nd;
+        V->capacity = nc;
+    }
+    V->data[V->size++] = x;
+}
+
+// Retire une occurrence de x (échange avec le dernier) ; 0 si absent
+static int vec_remove(IntVec *V, int x) {
+    for (int i = 0; i < V->size; ++i) {
+        if (V->data[i] == x) {
+            V->data[i] = V->data[--V->size];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Place pour au moins k entiers (contenu gardé)
+static void vec_reserve(IntVec *V, int k) {
+    if (k <= V->capacity) return;
+    int *nd = (int*)realloc(V->data, k * sizeof(int));
+    if (!nd) {
+        perror("realloc dynscc vector");
+        exit(EXIT_FAILURE);
+    }
+    V->data = nd;
+    V->capacity = k;
+}
+
+static void vec_free(IntVec *V) {
+    free(V->data);
+    V->data = NULL;
+    V->size = 0;
+    V->capacity = 0;
+}
+
+static void edges_add(DynEdges *E, int v, prob_t p) {
+    if (E->size >= E->capacity) {
+        int nc = (E->capacity < 4) ? 4 : E->capacity * 2;
+        int    *nd = (int*)realloc(E->dest, nc * sizeof(int));
+        prob_t *np = (prob_t*)realloc(E->prob, nc * sizeof(prob_t));
+        if (!nd || !np) {
+            perror("realloc dynscc edges");
+            exit(EXIT_FAILURE);
+        }
+        E->dest = nd;
+        E->prob = np;
+        E->capacity = nc;
+    }
+    E->dest[E->size] = v;
+    E->prob[E->size] = p;
+    E->size++;
+}
+
+static int edges_find(const DynEdges *E, int v) {
+    for (int i = 0; i < E->size; ++i)
+        if (E->dest[i] == v) return i;
+    return -1;
+}
+
+
+// ============================================================================
+//  Compteurs de liens (adressage ouvert, suppression par décalage arrière)
+// ============================================================================
+
+#define LINK_EMPTY UINT64_MAX
+
+static uint64_t link_key(int a, int b) {
+    return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+static size_t key_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+static LinkCounts counts_create(size_t expected) {
+    LinkCounts T;
+    size_t cap = 16;
+    while (cap < 2 * expected) cap *= 2;
+    T.keys = (uint64_t*)malloc(cap * sizeof(uint64_t));
+    T.counts = (int*)malloc(cap * sizeof(int));
+    if (!T.keys || !T.counts) {
+        perror("malloc link counts");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < cap; ++i) T.keys[i] = LINK_EMPTY;
+    T.mask = cap - 1;
+    T.size = 0;
+    return T;
+}
+
+// Vide la table sans rendre sa place
+static void counts_clear(LinkCounts *T) {
+    for (size_t i = 0; i <= T->mask; ++i) T->keys[i] = LINK_EMPTY;
+    T->size = 0;
+}
+
+static void counts_free(LinkCounts *T) {
+    free(T->keys);
+    free(T->counts);
+    T->keys = NULL;
+    T->counts = NULL;
+    T->mask = 0;
+    T->size = 0;
+}
+
+static size_t counts_slot(const LinkCounts *T, uint64_t key) {
+    size_t i = key_hash(key) & T->mask;
+    while (T->keys[i] != LINK_EMPTY && T->keys[i] != key) i = (i + 1) & T->mask;
+    return i;
+}
+
+// Ajoute delta au compteur de key et renvoie la nouvelle valeur
+// (la clé disparaît quand le compteur retombe à 0)
+static int counts_add(LinkCounts *T, uint64_t key, int delta) {
+    if (2 * (T->size + 1) > T->mask + 1) {
+        LinkCounts N = counts_create(T->size + 1);
+        for (size_t i = 0; i <= T->mask; ++i) {
+            if (T->keys[i] == LINK_EMPTY) continue;
+            size_t j = counts_slot(&N, T->keys[i]);
+            N.keys[j] = T->keys[i];
+            N.counts[j] = T->counts[i];
+            N.size++;
+        }
+        counts_free(T);
+        *T = N;
+    }
+
+    size_t i = counts_slot(T, key);
+    if (T->keys[i] == LINK_EMPTY) {
+        if (delta <= 0) return 0;
+        T->keys[i] = key;
+        T->counts[i] = delta;
+        T->size++;
+        return delta;
+    }
+    T->counts[i] += delta;
+    if (T->counts[i] > 0) return T->counts[i];
+
+    // suppression : on recule les clés suivantes du même groupe
+    T->keys[i] = LINK_EMPTY;
+    T->size--;
+    size_t j = i;
+    while (1) {
+        j = (j + 1) & T->mask;
+        if (T->keys[j] == LINK_EMPTY) break;
+        size_t home = key_hash(T->keys[j]) & T->mask;
+        // la clé en j peut-elle aller en i ? (home n’est pas dans ]i, j])
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            T->keys[i] = T->keys[j];
+            T->counts[i] = T->counts[j];
+            T->keys[j] = LINK_EMPTY;
+            i = j;
+        }
+    }
+    return 0;
+}
+
+static int counts_get(const LinkCounts *T, uint64_t key) {
+    size_t i = counts_slot(T, key);
+    return T->keys[i] == LINK_EMPTY ? 0 : T->counts[i];
+}
+
+
+// ============================================================================
+//  Liens entre classes
+// ============================================================================
+
+// k arcs de plus de a vers b ; renvoie 1 si le lien vient d’apparaître
+static int link_add(DynScc *S, int a, int b, int k) {
+    if (counts_add(&S->links, link_key(a, b), k) != k) return 0;
+    vec_push(&S->cls[a].out, b);
+    vec_push(&S->cls[b].in, a);
+    return 1;
+}
+
+// Un arc de moins de a vers b
+static void link_dec(DynScc *S, int a, int b) {
+    if (counts_add(&S->links, link_key(a, b), -1) == 0) {
+        vec_remove(&S->cls[a].out, b);
+        vec_remove(&S->cls[b].in, a);
+    }
+}
+
+// Retire complètement le lien a -> b de la table (listes non modifiées) ;
+// renvoie le nombre d’arcs qu’il portait
+static int link_take(DynScc *S, int a, int b) {
+    uint64_t key = link_key(a, b);
+    int k = counts_get(&S->links, key);
+    if (k > 0) counts_add(&S->links, key, -k);
+    return k;
+}
+
+
+// ============================================================================
+//  Classes
+// ============================================================================
+
+static int class_alloc(DynScc *S) {
+    int c;
+    if (S->free_ids.size > 0) {
+        c = S->free_ids.data[--S->free_ids.size];
+    } else {
+        if (S->ncls >= S->cls_capacity) {
+            int nc = (S->cls_capacity < 8) ? 8 : S->cls_capacity * 2;
+            DynClass *ncl = (DynClass*)realloc(S->cls, nc * sizeof(DynClass));
+            int *nm = (int*)realloc(S->mark, nc * sizeof(int));
+            if (!ncl || !nm) {
+                perror("realloc dynscc classes");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = S->cls_capacity; i < nc; ++i) nm[i] = 0;
+            S->cls = ncl;
+            S->mark = nm;
+            S->cls_capacity = nc;
+        }
+        c = S->ncls++;
+    }
+    memset(&S->cls[c], 0, sizeof(DynClass));
+    S->cls[c].alive = 1;
+    S->nalive++;
+    return c;
+}
+
+static void class_release(DynScc *S, int c) {
+    vec_free(&S->cls[c].members);
+    vec_free(&S->cls[c].out);
+    vec_free(&S->cls[c].in);
+    S->cls[c].alive = 0;
+    S->cls[c].dirty = 0;
+    vec_push(&S->free_ids, c);
+    S->nalive--;
+}
+
+static int next_stamp(DynScc *S) {
+    return ++S->stamp;
+}
+
+static void mark_dirty(DynScc *S, int c) {
+    if (S->cls[c].dirty) return;
+    S->cls[c].dirty = 1;
+    vec_push(&S->dirty, c);
+}
+
+// Écart entre deux rangs consécutifs d’un ordre recalculé : chaque classe
+// garde ]ord - gap, ord] pour les morceaux d’un futur redécoupage
+#define ORD_GAP ((int64_t)1 << 32)
+
+// Ordre topologique complet des classes vivantes (Kahn)
+static void renumber_order(DynScc *S) {
+    int *indeg = (int*)calloc(S->ncls > 0 ? S->ncls : 1, sizeof(int));
+    int *queue = (int*)malloc((S->ncls > 0 ? S->ncls : 1) * sizeof(int));
+    if (!indeg || !queue) {
+        perror("malloc dynscc order");
+        exit(EXIT_FAILURE);
+    }
+    int head = 0, tail = 0;
+    for (int c = 0; c < S->ncls; ++c) {
+        if (!S->cls[c].alive) continue;
+        indeg[c] = S->cls[c].in.size;
+        if (indeg[c] == 0) queue[tail++] = c;
+    }
+    while (head < tail) {
+        int c = queue[head];
+        S->cls[c].ord = (int64_t)head++ * ORD_GAP;
+        S->cls[c].gap = ORD_GAP;
+        for (int i = 0; i < S->cls[c].out.size; ++i) {
+            int d = S->cls[c].out.data[i];
+            if (--indeg[d] == 0) queue[tail++] = d;
+        }
+    }
+    free(indeg);
+    free(queue);
+}
+
+
+// ============================================================================
+//  Fusion de classes (nouveau cycle)
+// ============================================================================
+
+// Fusionne les classes de M (marquées avec stamp) ; renvoie la survivante
+static int merge_classes(DynScc *S, const IntVec *M, int stamp) {
+    int s = M->data[0];
+    char dirty = 0;
+    for (int i = 0; i < M->size; ++i) {
+        int c = M->data[i];
+        if (S->cls[c].members.size > S->cls[s].members.size) s = c;
+        dirty |= S->cls[c].dirty;
+    }
+
+    for (int i = 0; i < M->size; ++i) {
+        int a = M->data[i];
+        if (a == s) continue;
+        DynClass *A = &S->cls[a];
+
+        for (int k = 0; k < A->members.size; ++k) {
+            int w = A->members.data[k];
+            S->comp[w] = s;
+            vec_push(&S->cls[s].members, w);
+        }
+
+        // liens sortants : internes (vers M) supprimés, les autres reportés sur s
+        IntVec out = A->out;
+        A->out = (IntVec){ NULL, 0, 0 };
+        for (int k = 0; k < out.size; ++k) {
+            int b = out.data[k];
+            int cnt = link_take(S, a, b);
+            vec_remove(&S->cls[b].in, a);
+            if (S->mark[b] != stamp) link_add(S, s, b, cnt);
+        }
+        vec_free(&out);
+
+        IntVec in = A->in;
+        A->in = (IntVec){ NULL, 0, 0 };
+        for (int k = 0; k < in.size; ++k) {
+            int x = in.data[k];
+            int cnt = link_take(S, x, a);
+            vec_remove(&S->cls[x].out, a);
+            if (S->mark[x] != stamp) link_add(S, x, s, cnt);
+        }
+        vec_free(&in);
+
+        class_release(S, a);
+    }
+
+    if (dirty) mark_dirty(S, s);
+    return s;
+}
+
+
+// ============================================================================
+//  Nouveau lien a -> b : ordre topologique (Pearce-Kelly) et cycles
+// ============================================================================
+
+// Parcours depuis start dans la direction donnée, limité aux classes dont le
+// rang est dans [lo, hi] ; les classes atteintes sont marquées et listées,
+// classes et liens parcourus sont ajoutés à *work
+static void bounded_search(DynScc *S, int start, int forward, int64_t lo, int64_t hi,
+                           int stamp, IntVec *seen, IntVec *stack, int64_t *work) {
+    stack->size = 0;
+    S->mark[start] = stamp;
+    vec_push(seen, start);
+    vec_push(stack, start);
+    while (stack->size > 0) {
+        int c = stack->data[--stack->size];
+        const IntVec *next = forward ? &S->cls[c].out : &S->cls[c].in;
+        *work += 1 + next->size;
+        for (int i = 0; i < next->size; ++i) {
+            int d = next->data[i];
+            if (S->mark[d] == stamp || S->cls[d].ord < lo || S->cls[d].ord > hi) continue;
+            S->mark[d] = stamp;
+            vec_push(seen, d);
+            vec_push(stack, d);
+        }
+    }
+}
+
+// Rang et intervalle réservé : ils passent ensemble d’une classe à l’autre
+typedef struct {
+    int64_t ord;
+    int64_t gap;
+} DynRank;
+
+static int cmp_rank(const void *x, const void *y) {
+    int64_t a = ((const DynRank*)x)->ord, b = ((const DynRank*)y)->ord;
+    return (a > b) - (a < b);
+}
+
+static void rank_push(DynRank *pool, int *size, const DynClass *C) {
+    pool[*size].ord = C->ord;
+    pool[*size].gap = C->gap;
+    (*size)++;
+}
+
+// qsort n’a pas de contexte : l’état trié est passé par cette variable
+// (les lots sont appliqués par un seul thread)
+static const DynScc *sort_ctx;
+static int cmp_ord(const void *x, const void *y) {
+    int64_t a = sort_ctx->cls[*(const int*)x].ord, b = sort_ctx->cls[*(const int*)y].ord;
+    return (a > b) - (a < b);
+}
+
+static void sort_by_ord(DynScc *S, IntVec *V) {
+    if (V->size < 2) return;
+    sort_ctx = S;
+    qsort(V->data, V->size, sizeof(int), cmp_ord);
+}
+
+// Renvoie 1 si des classes ont été fusionnées ; le coût des deux parcours
+// est ajouté à *work
+static int order_new_link(DynScc *S, int a, int b, int64_t *work) {
+    int64_t lb = S->cls[b].ord, ub = S->cls[a].ord;
+    if (ub < lb) return 0;   // déjà dans l’ordre
+
+    IntVec F = { NULL, 0, 0 }, B = { NULL, 0, 0 }, stack = { NULL, 0, 0 };
+    int sf = next_stamp(S);
+    bounded_search(S, b, 1, lb, ub, sf, &F, &stack, work);
+    int cycle = (S->mark[a] == sf);
+
+    int sb = next_stamp(S);
+    // les marques de F sont écrasées par celles de B : on garde F dans inF
+    IntVec inF = { NULL, 0, 0 };
+    if (cycle) for (int i = 0; i < F.size; ++i) vec_push(&inF, F.data[i]);
+    bounded_search(S, a, 0, lb, ub, sb, &B, &stack, work);
+
+    // rangs disponibles : ceux de B ∪ F (disjoints sans cycle)
+    DynRank *pool = (DynRank*)malloc(((size_t)B.size + F.size) * sizeof(DynRank));
+    if (!pool) {
+        perror("malloc dynscc ranks");
+        exit(EXIT_FAILURE);
+    }
+    int npool = 0;
+    int merged = -1;
+    if (cycle) {
+        // M = F ∩ B : classes sur un chemin b ~> a
+        IntVec M = { NULL, 0, 0 };
+        for (int i = 0; i < inF.size; ++i)
+            if (S->mark[inF.data[i]] == sb) vec_push(&M, inF.data[i]);
+        int sm = next_stamp(S);
+        for (int i = 0; i < M.size; ++i) S->mark[M.data[i]] = sm;
+
+        IntVec B2 = { NULL, 0, 0 }, F2 = { NULL, 0, 0 };
+        for (int i = 0; i < B.size; ++i) {
+            rank_push(pool, &npool, &S->cls[B.data[i]]);
+            if (S->mark[B.data[i]] != sm) vec_push(&B2, B.data[i]);
+        }
+        for (int i = 0; i < F.size; ++i) {
+            if (S->mark[F.data[i]] == sm) continue;   // déjà compté dans B
+            rank_push(pool, &npool, &S->cls[F.data[i]]);
+            vec_push(&F2, F.data[i]);
+        }
+        merged = merge_classes(S, &M, sm);
+        vec_free(&M);
+
+        // nouvel ordre : B \ M, la classe fusionnée, F \ M
+        vec_free(&B);
+        vec_free(&F);
+        sort_by_ord(S, &B2);
+        sort_by_ord(S, &F2);
+        B = B2;
+        vec_push(&B, merged);
+        F = F2;
+    } else {
+        for (int i = 0; i < B.size; ++i) rank_push(pool, &npool, &S->cls[B.data[i]]);
+        for (int i = 0; i < F.size; ++i) rank_push(pool, &npool, &S->cls[F.data[i]]);
+        sort_by_ord(S, &B);
+        sort_by_ord(S, &F);
+    }
+
+    // réattribution des rangs : B prend les plus petits, F les plus grands
+    // (les rangs en trop après une fusion restent libres entre les deux)
+    qsort(pool, npool, sizeof(DynRank), cmp_rank);
+    for (int i = 0; i < B.size; ++i) {
+        S->cls[B.data[i]].ord = pool[i].ord;
+        S->cls[B.data[i]].gap = pool[i].gap;
+    }
+    for (int i = 0; i < F.size; ++i) {
+        S->cls[F.data[i]].ord = pool[npool - F.size + i].ord;
+        S->cls[F.data[i]].gap = pool[npool - F.size + i].gap;
+    }
+
+    free(pool);
+    vec_free(&inF);
+    vec_free(&stack);
+    vec_free(&B);
+    vec_free(&F);
+    return merged >= 0;
+}
+
+
+// ============================================================================
+//  Redécoupage d’une classe après suppressions (Tarjan local)
+// ============================================================================
+
+// Tarjan itératif limité aux arcs internes à la classe c. Les composantes
+// trouvées sont écrites dans S->piece (numéro de morceau par sommet, ordre
+// « puits d’abord ») ; renvoie le nombre de morceaux.
+static int local_tarjan(DynScc *S, int c, IntVec *stack, IntVec *calls) {
+    int *piece = S->piece;
+    const IntVec *mem = &S->cls[c].members;
+    int counter = 0, npieces = 0;
+    stack->size = 0;
+    calls->size = 0;
+
+    for (int r = 0; r < mem->size; ++r) {
+        int root = mem->data[r];
+        if (S->index[root] >= 0) continue;
+
+        S->index[root] = S->low[root] = counter++;
+        S->cursor[root] = 0;
+        vec_push(stack, root);
+        vec_push(calls, root);
+
+        while (calls->size > 0) {
+            int u = calls->data[calls->size - 1];
+            const DynEdges *E = &S->out[u];
+            if (S->cursor[u] < E->size) {
+                int v = E->dest[S->cursor[u]++];
+                if (S->comp[v] != c) continue;          // arc sortant de la classe
+                if (S->index[v] < 0) {
+                    S->index[v] = S->low[v] = counter++;
+                    S->cursor[v] = 0;
+                    vec_push(stack, v);
+                    vec_push(calls, v);
+                } else if (piece[v] < 0 && S->index[v] < S->low[u]) {
+                    S->low[u] = S->index[v];            // v encore sur la pile
+                }
+            } else {
+                calls->size--;
+                if (S->low[u] == S->index[u]) {
+                    int w;
+                    do {
+                        w = stack->data[--stack->size];
+                        piece[w] = npieces;
+                    } while (w != u);
+                    npieces++;
+                }
+                if (calls->size > 0) {
+                    int parent = calls->data[calls->size - 1];
+                    if (S->low[u] < S->low[parent]) S->low[parent] = S->low[u];
+                }
+            }
+        }
+    }
+    return npieces;
+}
+
+// Renvoie 1 si la classe a été découpée
+static int split_class(DynScc *S, int c, IntVec *stack, IntVec *calls) {
+    int *piece = S->piece;
+    IntVec *mem = &S->cls[c].members;
+    for (int k = 0; k < mem->size; ++k) piece[mem->data[k]] = -1;
+    int np = local_tarjan(S, c, stack, calls);
+    for (int k = 0; k < mem->size; ++k) S->index[mem->data[k]] = -1;
+    if (np <= 1) return 0;
+
+    // on oublie les liens de c : ils sont recomptés morceau par morceau
+    for (int i = 0; i < S->cls[c].out.size; ++i) {
+        int b = S->cls[c].out.data[i];
+        link_take(S, c, b);
+        vec_remove(&S->cls[b].in, c);
+    }
+    for (int i = 0; i < S->cls[c].in.size; ++i) {
+        int x = S->cls[c].in.data[i];
+        link_take(S, x, c);
+        vec_remove(&S->cls[x].out, c);
+    }
+    S->cls[c].out.size = 0;
+    S->cls[c].in.size = 0;
+
+    // le morceau 0 garde l’identifiant c, les autres en reçoivent un nouveau.
+    // Rangs pris dans ]ord - gap, ord] : les prédécesseurs de c sont sous
+    // cet intervalle, ses successeurs au-dessus ; le morceau k (puits
+    // d’abord) reçoit ord - k * step, donc un arc entre morceaux va vers un
+    // rang plus grand.
+    int64_t ord = S->cls[c].ord;
+    int64_t step = S->cls[c].gap / np;
+    IntVec old = S->cls[c].members;
+    S->cls[c].members = (IntVec){ NULL, 0, 0 };
+    int *ids = (int*)malloc(np * sizeof(int));
+    if (!ids) {
+        perror("malloc dynscc pieces");
+        exit(EXIT_FAILURE);
+    }
+    ids[0] = c;
+    for (int k = 1; k < np; ++k) ids[k] = class_alloc(S);   // peut déplacer S->cls
+    int stamp = next_stamp(S);
+    for (int k = 0; k < np; ++k) {
+        S->mark[ids[k]] = stamp;
+        S->cls[ids[k]].dirty = 0;
+        S->cls[ids[k]].ord = ord - k * step;
+        S->cls[ids[k]].gap = step;
+    }
+    for (int k = 0; k < old.size; ++k) {
+        int w = old.data[k];
+        S->comp[w] = ids[piece[w]];
+        vec_push(&S->cls[S->comp[w]].members, w);
+    }
+
+    // recomptage : arcs sortants de chaque sommet, et arcs entrants venant
+    // d’autres classes (ceux entre morceaux sont déjà vus comme sortants)
+    for (int k = 0; k < old.size; ++k) {
+        int w = old.data[k], p = S->comp[w];
+        const DynEdges *E = &S->out[w];
+        for (int e = 0; e < E->size; ++e)
+            if (S->comp[E->dest[e]] != p) link_add(S, p, S->comp[E->dest[e]], 1);
+        const IntVec *I = &S->in[w];
+        for (int e = 0; e < I->size; ++e)
+            if (S->mark[S->comp[I->data[e]]] != stamp) link_add(S, S->comp[I->data[e]], p, 1);
+    }
+
+    vec_free(&old);
+    free(ids);
+    // intervalle épuisé (des dizaines de redécoupages emboîtés) : on
+    // repart d’un ordre complet
+    if (step == 0) renumber_order(S);
+    return 1;
+}
+
+
+// ============================================================================
+//  Classes depuis une partition (création, recalcul complet)
+// ============================================================================
+
+/*
+   Liens entre classes depuis les arcs : pour chaque classe, arcs comptés
+   par classe d’arrivée (cursor, libre hors Tarjan local, sert de compteur
+   par classe), puis une insertion par lien. Les tableaux out / in et la
+   table gardent leur place.
+*/
+static void build_links(DynScc *S) {
+    counts_clear(&S->links);
+    for (int c = 0; c < S->ncls; ++c) {
+        if (!S->cls[c].alive) continue;
+        S->cls[c].out.size = 0;
+        S->cls[c].in.size = 0;
+    }
+
+    int *count = S->cursor;
+    IntVec targets = { NULL, 0, 0 };
+    for (int a = 0; a < S->ncls; ++a) {
+        if (!S->cls[a].alive) continue;
+        int stamp = next_stamp(S);
+        targets.size = 0;
+        const IntVec *M = &S->cls[a].members;
+        for (int k = 0; k < M->size; ++k) {
+            const DynEdges *E = &S->out[M->data[k]];
+            for (int e = 0; e < E->size; ++e) {
+                int b = S->comp[E->dest[e]];
+                if (b == a) continue;
+                if (S->mark[b] != stamp) {
+                    S->mark[b] = stamp;
+                    count[b] = 0;
+                    vec_push(&targets, b);
+                }
+                count[b]++;
+            }
+        }
+        for (int t = 0; t < targets.size; ++t) link_add(S, a, targets.data[t], count[targets.data[t]]);
+    }
+    vec_free(&targets);
+    S->links_stale = 0;
+}
+
+// Crée une classe par classe de P (identifiants 0..P->size-1 si aucune
+// classe n’existe encore), puis compte les liens
+static void classes_from_partition(DynScc *S, const TarjanPartition *P) {
+    int n = S->n;
+    int *v2c = build_vertex_to_class(P, n);
+    for (int c = 0; c < P->size; ++c) class_alloc(S);
+    for (int v = 1; v <= n; ++v) {
+        if (v2c[v] < 0) v2c[v] = class_alloc(S);   // sommet absent de P
+        S->comp[v] = v2c[v];
+        vec_push(&S->cls[v2c[v]].members, v);
+    }
+    free(v2c);
+
+    S->links = counts_create((size_t)S->ncls);
+    build_links(S);
+}
+
+// Graphe CSR des arcs courants (pour un Tarjan global)
+static CsrGraph dyn_to_csr(const DynScc *S) {
+    CsrGraph G;
+    memset(&G, 0, sizeof(G));
+    G.n = S->n;
+    G.m = S->m;
+    G.row = (int64_t*)malloc(((size_t)S->n + 2) * sizeof(int64_t));
+    G.dest = (int*)malloc(((size_t)S->m > 0 ? (size_t)S->m : 1) * sizeof(int));
+    G.prob = (prob_t*)malloc(((size_t)S->m > 0 ? (size_t)S->m : 1) * sizeof(prob_t));
+    if (!G.row || !G.dest || !G.prob) {
+        perror("malloc dynscc csr");
+        exit(EXIT_FAILURE);
+    }
+    G.row[0] = G.row[1] = 0;
+    for (int u = 1; u <= S->n; ++u) {
+        const DynEdges *E = &S->out[u];
+        if (E->size > 0) {
+            memcpy(G.dest + G.row[u], E->dest, (size_t)E->size * sizeof(int));
+            memcpy(G.prob + G.row[u], E->prob, (size_t)E->size * sizeof(prob_t));
+        }
+        G.row[u + 1] = G.row[u] + E->size;
+    }
+    return G;
+}
+
+/*
+   Recalcul complet : Tarjan sur tout le graphe, classes reprises de la
+   partition à plat dans les emplacements existants (tableaux members, out
+   et in réutilisés). Tarjan rend les puits d’abord : les rangs s’en
+   déduisent directement, sans tri topologique. Les liens ne sont pas
+   recomptés ici : marqués périmés, ils le sont au prochain lot traité
+   incrémentalement (build_links), et pas du tout si les lots suivants
+   finissent eux aussi par un recalcul.
+*/
+static void rebuild_classes(DynScc *S) {
+    CsrGraph G = dyn_to_csr(S);
+    TarjanPartition P = tarjan_run_csr(&G);
+    csr_free(&G);
+
+    // emplacements au-delà des nouvelles classes : rendus
+    for (int c = P.size; c < S->ncls; ++c) {
+        if (!S->cls[c].alive) continue;
+        vec_free(&S->cls[c].members);
+        vec_free(&S->cls[c].out);
+        vec_free(&S->cls[c].in);
+    }
+    int reused = S->ncls < P.size ? S->ncls : P.size;
+    S->ncls = reused;
+    S->free_ids.size = 0;
+    S->nalive = 0;
+    for (int c = 0; c < P.size; ++c) {
+        if (c >= reused) {
+            class_alloc(S);
+        } else {
+            DynClass *C = &S->cls[c];   // identifiant libre : tableaux déjà rendus (NULL)
+            C->members.size = C->out.size = C->in.size = 0;
+            C->alive = 1;
+            C->dirty = 0;
+            S->nalive++;
+        }
+        DynClass *C = &S->cls[c];
+        vec_reserve(&C->members, P.classes[c].size);
+        memcpy(C->members.data, P.classes[c].members, (size_t)P.classes[c].size * sizeof(int));
+        C->members.size = P.classes[c].size;
+        C->ord = (int64_t)(P.size - 1 - c) * ORD_GAP;
+        C->gap = ORD_GAP;
+    }
+    memcpy(S->comp, P.class_of, ((size_t)S->n + 1) * sizeof(int));
+    partition_free(&P);
+    S->links_stale = 1;
+}
+
+
+// ============================================================================
+//  API
+// ============================================================================
+
+DynScc dynscc_create(const CsrGraph *G, const TarjanPartition *P) {
+    DynScc S;
+    memset(&S, 0, sizeof(S));
+    int n = G->n;
+    S.n = n;
+    S.m = G->m;
+    S.out = (DynEdges*)calloc((size_t)n + 1, sizeof(DynEdges));
+    S.in = (IntVec*)calloc((size_t)n + 1, sizeof(IntVec));
+    S.comp = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    S.index = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    S.low = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    S.cursor = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    S.piece = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (!S.out || !S.in || !S.comp || !S.index || !S.low || !S.cursor || !S.piece) {
+        perror("malloc dynscc");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v <= n; ++v) S.index[v] = -1;
+
+    for (int u = 1; u <= n; ++u) {
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k) {
+            edges_add(&S.out[u], G->dest[k], G->prob[k]);
+            vec_push(&S.in[G->dest[k]], u);
+        }
+    }
+
+    // classes de départ : celles de P (ou de Tarjan)
+    TarjanPartition own;
+    if (!P) {
+        own = tarjan_run_csr(G);
+        P = &own;
+    }
+    classes_from_partition(&S, P);
+    if (P == &own) partition_free(&own);
+    renumber_order(&S);   // P donnée peut être dans n’importe quel ordre
+    return S;
+}
+
+void dynscc_apply(DynScc *S, const EdgeUpdate *updates, int count, DynSccReport *report) {
+    DynSccReport R;
+    memset(&R, 0, sizeof(R));
+    S->dirty.size = 0;
+
+    // travail incrémental du lot : classes et liens parcourus pour l’ordre,
+    // puis sommets des classes à revérifier. Au-delà du budget, les arcs
+    // restants sont seulement appliqués et le lot finit par un recalcul
+    // complet, qui coûte alors moins cher. Après des recalculs de suite,
+    // le lot part budget épuisé (direct) et les liens restent périmés.
+    int direct = S->skip > 0;
+    if (direct) S->skip--;
+    else if (S->links_stale) build_links(S);
+    int64_t budget = S->n / DYNSCC_REBUILD_DIVISOR;
+    int64_t work = direct ? budget + 1 : 0;
+
+    for (int i = 0; i < count; ++i) {
+        int u = updates[i].u, v = updates[i].v;
+        if (u < 1 || u > S->n || v < 1 || v > S->n) {
+            R.ignored++;
+            continue;
+        }
+        int e = edges_find(&S->out[u], v);
+        int cu = S->comp[u], cv = S->comp[v];
+
+        if (updates[i].insert) {
+            if (e >= 0) {
+                S->out[u].prob[e] = updates[i].p;   // seul le poids change
+                R.reweighted++;
+                continue;
+            }
+            edges_add(&S->out[u], v, updates[i].p);
+            vec_push(&S->in[v], u);
+            S->m++;
+            R.inserted++;
+            if (work > budget) continue;
+            if (cu != cv && link_add(S, cu, cv, 1))
+                R.merges += order_new_link(S, cu, cv, &work);
+        } else {
+            if (e < 0) {
+                R.ignored++;
+                continue;
+            }
+            DynEdges *E = &S->out[u];
+            E->size--;
+            E->dest[e] = E->dest[E->size];
+            E->prob[e] = E->prob[E->size];
+            vec_remove(&S->in[v], u);
+            S->m--;
+            R.deleted++;
+            if (work > budget) continue;
+            if (cu != cv) link_dec(S, cu, cv);
+            else mark_dirty(S, cu);
+        }
+    }
+
+    // classes qui ont perdu un arc interne : Tarjan local, ou recalcul
+    // complet si le lot a dépassé son budget
+    for (int i = 0; i < S->dirty.size && work <= budget; ++i) {
+        int c = S->dirty.data[i];
+        if (!S->cls[c].alive || !S->cls[c].dirty) continue;
+        R.checked++;
+        work += S->cls[c].members.size;
+    }
+    if (work > budget) {
+        rebuild_classes(S);
+        R.rebuilt = 1;
+        if (!direct) {
+            // essai incrémental manqué : 1, 3, 7... lots directs avant le suivant
+            if (S->rebuild_run < 30) S->rebuild_run++;
+            int64_t skip = ((int64_t)1 << S->rebuild_run) - 1;
+            S->skip = skip < DYNSCC_MAX_DIRECT ? (int)skip : DYNSCC_MAX_DIRECT;
+        }
+    } else if (R.checked > 0) {
+        IntVec stack = { NULL, 0, 0 }, calls = { NULL, 0, 0 };
+        for (int i = 0; i < S->dirty.size; ++i) {
+            int c = S->dirty.data[i];
+            if (!S->cls[c].alive || !S->cls[c].dirty) continue;
+            S->cls[c].dirty = 0;
+            R.splits += split_class(S, c, &stack, &calls);
+        }
+        vec_free(&stack);
+        vec_free(&calls);
+    }
+    if (!R.rebuilt) S->rebuild_run = 0;
+    S->dirty.size = 0;
+
+    if (report) *report = R;
+}
+
+int dynscc_class_of(const DynScc *S, int v) {
+    return (v >= 1 && v <= S->n) ? S->comp[v] : -1;
+}
+
+int dynscc_is_closed(const DynScc *S, int c) {
+    if (c < 0 || c >= S->ncls || !S->cls[c].alive) return 0;
+    if (!S->links_stale) return S->cls[c].out.size == 0;
+    // liens périmés : arcs des membres
+    const IntVec *M = &S->cls[c].members;
+    for (int k = 0; k < M->size; ++k) {
+        const DynEdges *E = &S->out[M->data[k]];
+        for (int e = 0; e < E->size; ++e)
+            if (S->comp[E->dest[e]] != c) return 0;
+    }
+    return 1;
+}
+
+int dynscc_class_count(const DynScc *S) {
+    return S->nalive;
+}
+
+void dynscc_snapshot(const DynScc *S, TarjanPartition *P, t_link_array *L, CsrGraph *G) {
+    // classes vivantes, rang topologique décroissant (puits d’abord)
+    int *order = (int*)malloc((S->nalive > 0 ? S->nalive : 1) * sizeof(int));
+    int *idx = (int*)malloc((S->ncls > 0 ? S->ncls : 1) * sizeof(int));
+    if (!order || !idx) {
+        perror("malloc dynscc snapshot");
+        exit(EXIT_FAILURE);
+    }
+    int k = 0;
+    for (int c = 0; c < S->ncls; ++c)
+        if (S->cls[c].alive) order[k++] = c;
+    sort_ctx = S;
+    qsort(order, k, sizeof(int), cmp_ord);
+    for (int i = 0; i < k / 2; ++i) {
+        int t = order[i];
+        order[i] = order[k - 1 - i];
+        order[k - 1 - i] = t;
+    }
+    for (int i = 0; i < k; ++i) idx[order[i]] = i;
+
+    if (P) {
+        *P = partition_create_pooled(S->n);
+        for (int i = 0; i < k; ++i) {
+            const IntVec *mem = &S->cls[order[i]].members;
+            char name[CLASS_NAME_SIZE];
+            snprintf(name, sizeof(name), "C%d", i + 1);
+            TarjanClass C = partition_new_class(P, name, mem->size);
+            for (int j = 0; j < mem->size; ++j) class_add_member(&C, mem->data[j]);
+            partition_add_class(P, C);
+        }
+        partition_finalize(P, S->n);
+    }
+
+    if (L) {
+        // depuis les arcs (les liens de S peuvent être périmés) ; seen[j] :
+        // dernière classe source qui a déjà un lien vers j
+        int *seen = (int*)malloc((k > 0 ? k : 1) * sizeof(int));
+        if (!seen) {
+            perror("malloc dynscc snapshot");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < k; ++i) seen[i] = -1;
+        L->data = NULL;
+        L->size = 0;
+        L->capacity = 0;
+        for (int i = 0; i < k; ++i) {
+            const IntVec *mem = &S->cls[order[i]].members;
+            for (int t = 0; t < mem->size; ++t) {
+                const DynEdges *E = &S->out[mem->data[t]];
+                for (int e = 0; e < E->size; ++e) {
+                    int j = idx[S->comp[E->dest[e]]];
+                    if (j == i || seen[j] == i) continue;
+                    seen[j] = i;
+                    if (L->size >= L->capacity) {
+                        int nc = (L->capacity < 8) ? 8 : L->capacity * 2;
+                        t_link *nd = (t_link*)realloc(L->data, nc * sizeof(t_link));
+                        if (!nd) {
+                            perror("realloc dynscc links");
+                            exit(EXIT_FAILURE);
+                        }
+                        L->data = nd;
+                        L->capacity = nc;
+                    }
+                    L->data[L->size].from = i;
+                    L->data[L->size].to = j;
+                    L->size++;
+                }
+            }
+        }
+        free(seen);
+    }
+
+    if (G) {
+        EdgeList E = edges_create();
+        for (int u = 1; u <= S->n; ++u)
+            for (int e = 0; e < S->out[u].size; ++e)
+                edges_push(&E, u, S->out[u].dest[e], S->out[u].prob[e]);
+        *G = csr_from_edges(S->n, &E);
+        edges_free(&E);
+    }
+
+    free(order);
+    free(idx);
+}
+
+void dynscc_free(DynScc *S) {
+    if (!S) return;
+    for (int v = 0; v <= S->n; ++v) {
+        free(S->out[v].dest);
+        free(S->out[v].prob);
+        vec_free(&S->in[v]);
+    }
+    for (int c = 0; c < S->ncls; ++c) {
+        if (!S->cls[c].alive) continue;
+        vec_free(&S->cls[c].members);
+        vec_free(&S->cls[c].out);
+        vec_free(&S->cls[c].in);
+    }
+    free(S->out);
+    free(S->in);
+    free(S->comp);
+    free(S->cls);
+    free(S->mark);
+    free(S->index);
+    free(S->low);
+    free(S->cursor);
+    free(S->piece);
+    vec_free(&S->free_ids);
+    vec_free(&S->dirty);
+    counts_free(&S->links);
+    memset(S, 0, sizeof(*S));
+}
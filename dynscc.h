@@ -0,0 +1,148 @@
+#ifndef DYNSCC_H
+#define DYNSCC_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "tarjan.h"
+
+/*
+   Maintenance incrémentale des classes (SCC) sous des lots d’ajouts et de
+   suppressions d’arcs, sans relancer readGraph / tarjan_run /
+   build_class_links à chaque modification.
+
+   - le graphe est gardé sous forme de listes d’arcs sortants et entrants
+     modifiables ;
+   - les liens entre classes sont des compteurs d’arcs (table de hachage
+     sur (classe, classe)), une classe est persistante tant qu’elle n’a
+     aucun lien sortant ;
+   - les classes gardent un ordre topologique maintenu à chaque nouveau
+     lien (Pearce-Kelly) : un ajout qui respecte l’ordre coûte O(1), sinon
+     seule la zone entre les deux classes est explorée, et les classes qui
+     se retrouvent sur un cycle sont fusionnées ;
+   - une suppression à l’intérieur d’une classe la marque « à vérifier » ;
+     en fin de lot, chaque classe marquée est redécoupée par un Tarjan
+     limité à ses sommets. Les morceaux prennent leurs rangs dans
+     l’intervalle réservé à la classe (ils sortent puits d’abord de Tarjan),
+     sans renuméroter les autres classes ;
+   - un lot dont le travail incrémental (classes et liens parcourus pour
+     l’ordre, sommets des classes à vérifier) dépasse n / DYNSCC_REBUILD_DIVISOR
+     n’applique plus que les arcs et se termine par un recalcul complet des
+     classes, moins cher que des parcours locaux sur presque tout le graphe ;
+   - le recalcul complet ne refait que les classes et leurs rangs : les
+     liens sont recomptés au prochain lot traité incrémentalement. Après r
+     lots de suite finis par un recalcul, les 2^r - 1 lots suivants (au plus
+     DYNSCC_MAX_DIRECT) vont directement au recalcul sans toucher aux liens :
+     sous un flot de grands changements, un lot coûte un recalcul simple.
+*/
+
+#ifndef DYNSCC_REBUILD_DIVISOR
+#define DYNSCC_REBUILD_DIVISOR 4
+#endif
+
+#ifndef DYNSCC_MAX_DIRECT
+#define DYNSCC_MAX_DIRECT 16
+#endif
+
+// Modification d’un arc
+typedef struct {
+    int    u, v;      // arc u -> v (sommets 1..n)
+    prob_t p;         // nouvelle probabilité (ajout ou changement de poids)
+    int    insert;    // 1 : ajout / changement de poids, 0 : suppression
+} EdgeUpdate;
+
+// Bilan d’un lot
+typedef struct {
+    int inserted;     // arcs ajoutés
+    int reweighted;   // arcs existants dont seul le poids a changé
+    int deleted;      // arcs supprimés
+    int ignored;      // suppressions d’arcs absents, sommets hors bornes
+    int merges;       // fusions de classes (nouveaux cycles), avant un recalcul complet
+    int splits;       // classes redécoupées après suppressions (0 si rebuilt)
+    int checked;      // classes revérifiées (par Tarjan local, ou avant le recalcul)
+    int rebuilt;      // 1 : budget dépassé (ou lot direct), classes recalculées en entier
+} DynSccReport;
+
+// Listes d’arcs modifiables d’un sommet
+typedef struct {
+    int    *dest;
+    prob_t *prob;
+    int     size;
+    int     capacity;
+} DynEdges;
+
+// Tableau d’entiers extensible
+typedef struct {
+    int *data;
+    int  size;
+    int  capacity;
+} IntVec;
+
+// Classe vivante (les identifiants des classes fusionnées sont recyclés)
+typedef struct {
+    IntVec  members;  // sommets de la classe
+    IntVec  out;      // classes atteintes par au moins un arc
+    IntVec  in;       // classes qui l’atteignent
+    int64_t ord;      // rang dans l’ordre topologique des classes
+    int64_t gap;      // rangs ]ord - gap, ord] réservés à la classe (redécoupage)
+    char    alive;
+    char    dirty;    // suppression interne : à revérifier en fin de lot
+} DynClass;
+
+// Table (classe a, classe b) -> nombre d’arcs de a vers b
+typedef struct {
+    uint64_t *keys;
+    int      *counts;
+    size_t    mask;
+    size_t    size;
+} LinkCounts;
+
+typedef struct {
+    int        n;          // sommets 1..n
+    int64_t    m;          // arcs
+    DynEdges  *out;        // arcs sortants de chaque sommet
+    IntVec    *in;         // origines des arcs entrants de chaque sommet
+    int       *comp;       // classe de chaque sommet
+    DynClass  *cls;
+    int        ncls;       // identifiants attribués
+    int        cls_capacity;
+    int        nalive;     // classes vivantes
+    IntVec     free_ids;   // identifiants libres
+    LinkCounts links;
+    int        links_stale; // 1 : out, in et links à recompter (après un recalcul complet)
+    int        rebuild_run; // essais incrémentaux de suite finis par un recalcul
+    int        skip;        // lots à venir traités directement par recalcul
+    // tampons de travail
+    int       *mark;       // par classe
+    int        stamp;
+    int       *index;      // par sommet (Tarjan local), -1 hors parcours
+    int       *low;
+    int       *cursor;
+    int       *piece;      // par sommet : morceau trouvé par le Tarjan local
+    IntVec     dirty;      // classes à revérifier dans le lot courant
+} DynScc;
+
+// État initial depuis un graphe et sa partition (partition recalculée si
+// P est NULL)
+DynScc dynscc_create(const CsrGraph *G, const TarjanPartition *P);
+
+// Applique un lot de modifications, dans l’ordre
+void dynscc_apply(DynScc *S, const EdgeUpdate *updates, int count, DynSccReport *report);
+
+// Classe courante du sommet v (identifiant interne, stable entre deux lots
+// tant que la classe n’est ni fusionnée ni redécoupée)
+int dynscc_class_of(const DynScc *S, int v);
+
+// 1 si la classe est persistante (aucun lien sortant), 0 si transitoire
+int dynscc_is_closed(const DynScc *S, int c);
+
+// Nombre de classes vivantes
+int dynscc_class_count(const DynScc *S);
+
+// Instantané dans les structures habituelles : partition (puits d’abord,
+// comme Tarjan, noms C1...), liens entre classes (indices de la partition)
+// et graphe CSR. Chaque pointeur peut être NULL.
+void dynscc_snapshot(const DynScc *S, TarjanPartition *P, t_link_array *L, CsrGraph *G);
+
+void dynscc_free(DynScc *S);
+
+#endif // DYNSCC_H
@@ -1,9 +1,11 @@
 #include "graph.h"
+#include "loader.h"
 #include <string.h>
 #include <math.h>
+#include <float.h>
 
 /* Créé une cellule (un arc) dans la liste d’adjacence */
-Cell* make_cell(int dest, float prob) {
+Cell* make_cell(int dest, prob_t prob) {
     Cell *c = (Cell*)malloc(sizeof(Cell));
     if (!c) {
         perror("malloc");
@@ -23,7 +25,7 @@ List make_list(void) {
 }
 
 /* Ajoute une cellule en tête de liste (opération push-front classique) */
-void list_push_front(List *L, int dest, float prob) {
+void list_push_front(List *L, int dest, prob_t prob) {
     Cell *c = make_cell(dest, prob);
     c->next = L->head;
     L->head = c;
@@ -56,16 +58,33 @@ AdjList adj_create(int n) {
     for (int i = 0; i <= n; ++i)
         G.arr[i] = make_list();
 
+    G.arena = NULL;
+    return G;
+}
+
+/* Même graphe vide, mais les cellules seront découpées dans une arène
+   dimensionnée pour `edges` arcs : un seul bloc, libéré d’un coup */
+AdjList adj_create_pooled(int n, int64_t edges) {
+    AdjList G = adj_create(n);
+    G.arena = arena_new((size_t)(edges > 0 ? edges : 1) * sizeof(Cell));
     return G;
 }
 
 /* Ajout d’un arc u -> v avec probabilité p */
-void adj_add_edge(AdjList *G, int u, int v, float p) {
+void adj_add_edge(AdjList *G, int u, int v, prob_t p) {
     if (u < 1 || u > G->n || v < 1 || v > G->n) {
         fprintf(stderr, "Edge out of bounds: %d -> %d\n", u, v);
         exit(EXIT_FAILURE);
     }
-    list_push_front(&G->arr[u], v, p);
+    if (!G->arena) {
+        list_push_front(&G->arr[u], v, p);
+        return;
+    }
+    Cell *c = (Cell*)arena_alloc(G->arena, sizeof(Cell));
+    c->dest = v;
+    c->prob = p;
+    c->next = G->arr[u].head;
+    G->arr[u].head = c;
 }
 
 /* Affiche la liste d’adjacence complète du graphe */
@@ -80,12 +99,18 @@ void adj_print(const AdjList *G) {
 void adj_free(AdjList *G) {
     if (!G || !G->arr) return;
 
-    for (int u = 1; u <= G->n; ++u) {
-        Cell *cur = G->arr[u].head;
-        while (cur) {
-            Cell *nxt = cur->next;
-            free(cur);  // libère chaque cellule
-            cur = nxt;
+    if (G->arena) {
+        // toutes les cellules sont dans l’arène : pas de parcours
+        arena_delete(G->arena);
+        G->arena = NULL;
+    } else {
+        for (int u = 1; u <= G->n; ++u) {
+            Cell *cur = G->arr[u].head;
+            while (cur) {
+                Cell *nxt = cur->next;
+                free(cur);  // libère chaque cellule
+                cur = nxt;
+            }
         }
     }
 
@@ -96,40 +121,35 @@ void adj_free(AdjList *G) {
 
 /* Lit un fichier texte et construit le graphe correspondant */
 AdjList readGraph(const char *filename) {
-    FILE *file = fopen(filename, "rt");
-    if (file == NULL) {
-        perror("Could not open file for reading");
-        exit(EXIT_FAILURE);
-    }
+    // lecture des arcs du fichier (projection mémoire, sans fscanf)
+    EdgeList E = edges_create();
+    int nbvert = load_edges(filename, 1, &E);
 
-    int nbvert;
-    if (fscanf(file, "%d", &nbvert) != 1) {
-        perror("Could not read number of vertices");
-        fclose(file);
-        exit(EXIT_FAILURE);
-    }
+    // création du graphe (cellules regroupées dans une arène)
+    AdjList G = adj_create_pooled(nbvert, E.size);
+    for (int64_t i = 0; i < E.size; ++i)
+        adj_add_edge(&G, E.from[i], E.to[i], E.prob[i]);
 
-    // création du graphe
-    AdjList G = adj_create(nbvert);
-
-    int depart, arrivee;
-    float proba;
-
-    // lecture des arcs du fichier
-    while (fscanf(file, "%d %d %f", &depart, &arrivee, &proba) == 3) {
-        adj_add_edge(&G, depart, arrivee, proba);
-    }
-
-    fclose(file);
+    edges_free(&E);
     return G;
 }
 
+/* Liste d’adjacence depuis un graphe CSR : les arcs sont repoussés en tête
+   du dernier au premier, l’ordre des listes est donc celui du CSR */
+AdjList adj_from_csr(const CsrGraph *G, int pooled) {
+    AdjList A = pooled ? adj_create_pooled(G->n, G->m) : adj_create(G->n);
+    for (int u = 1; u <= G->n; ++u)
+        for (int64_t k = G->row[u + 1] - 1; k >= G->row[u]; --k)
+            adj_add_edge(&A, u, G->dest[k], G->prob[k]);
+    return A;
+}
+
 /* Vérifie si chaque ligne du graphe suit les règles d’une distribution de probas */
 bool adj_is_markov(const AdjList *G) {
     bool is_ok = true;
 
     for (int u = 1; u <= G->n; ++u) {
-        float sum = 0.0f;
+        acc_t sum = 0;
 
         // somme des probabilités sortantes de u
         const Cell *cur = G->arr[u].head;
@@ -148,59 +168,557 @@ bool adj_is_markov(const AdjList *G) {
     return is_ok;
 }
 
-/* Convertit un entier en identifiant style A, B, C, AA, AB… (pour Mermaid) */
-char *getId(int num) {
-    static char buffer[8];
+/* ---------- Tableau d’arcs ---------- */
+
+/* Créé un tableau d’arcs vide */
+EdgeList edges_create(void) {
+    EdgeList E;
+    E.from = NULL;
+    E.to = NULL;
+    E.prob = NULL;
+    E.size = 0;
+    E.capacity = 0;
+    return E;
+}
+
+/* Ajoute un arc u -> v (le tableau double de taille si besoin) */
+void edges_push(EdgeList *E, int u, int v, prob_t p) {
+    if (E->size >= E->capacity) {
+        int64_t nc = (E->capacity < 64) ? 64 : E->capacity * 2;
+        int    *nf = (int*)realloc(E->from, nc * sizeof(int));
+        int    *nt = (int*)realloc(E->to, nc * sizeof(int));
+        prob_t *np = (prob_t*)realloc(E->prob, nc * sizeof(prob_t));
+        if (!nf || !nt || !np) {
+            perror("realloc edges");
+            exit(EXIT_FAILURE);
+        }
+        E->from = nf;
+        E->to = nt;
+        E->prob = np;
+        E->capacity = nc;
+    }
+    E->from[E->size] = u;
+    E->to[E->size] = v;
+    E->prob[E->size] = p;
+    E->size++;
+}
+
+/* Libère le tableau d’arcs */
+void edges_free(EdgeList *E) {
+    free(E->from);
+    free(E->to);
+    free(E->prob);
+    *E = edges_create();
+}
+
+
+/* ---------- Graphe CSR ---------- */
+
+/* Alloue un graphe CSR de n sommets et m arcs (offsets non remplis) */
+static CsrGraph csr_alloc(int n, int64_t m) {
+    CsrGraph G;
+    G.n = n;
+    G.m = m;
+    G.storage = NULL;
+    G.release = NULL;
+    G.row = (int64_t*)calloc((size_t)n + 2, sizeof(int64_t));
+    G.dest = (int*)malloc((m > 0 ? m : 1) * sizeof(int));
+    G.prob = (prob_t*)malloc((m > 0 ? m : 1) * sizeof(prob_t));
+    if (!G.row || !G.dest || !G.prob) {
+        perror("malloc csr");
+        exit(EXIT_FAILURE);
+    }
+    return G;
+}
+
+/*
+   Construit le graphe CSR à partir de plusieurs tableaux d’arcs, lus dans
+   l’ordre (tri par comptage, sans concaténation préalable).
+   Les arcs d’un sommet sont rangés du dernier lu au premier, comme le fait
+   list_push_front : csr_from_edges et csr_from_adj(readGraph) coïncident.
+*/
+CsrGraph csr_from_edge_lists(int n, const EdgeList *lists, int count) {
+    int64_t m = 0;
+    for (int l = 0; l < count; ++l)
+        m += lists[l].size;
+
+    CsrGraph G = csr_alloc(n, m);
+
+    // 1) degré sortant de chaque sommet, rangé dans row[u+1]
+    for (int l = 0; l < count; ++l) {
+        const EdgeList *E = &lists[l];
+        for (int64_t i = 0; i < E->size; ++i) {
+            int u = E->from[i], v = E->to[i];
+            if (u < 1 || u > n || v < 1 || v > n) {
+                fprintf(stderr, "Edge out of bounds: %d -> %d\n", u, v);
+                exit(EXIT_FAILURE);
+            }
+            G.row[u + 1]++;
+        }
+    }
+
+    // 2) somme préfixe : row[u+1] = fin de la ligne u
+    for (int u = 1; u <= n; ++u)
+        G.row[u + 1] += G.row[u];
+
+    // 3) remplissage par la fin : row[u+1] redescend jusqu’au début de u
+    for (int l = 0; l < count; ++l) {
+        const EdgeList *E = &lists[l];
+        for (int64_t i = 0; i < E->size; ++i) {
+            int64_t pos = --G.row[E->from[i] + 1];
+            G.dest[pos] = E->to[i];
+            G.prob[pos] = E->prob[i];
+        }
+    }
+
+    // 4) décalage : row[u] = début de la ligne u
+    for (int u = 0; u <= n; ++u)
+        G.row[u] = G.row[u + 1];
+    G.row[0] = 0;
+    G.row[n + 1] = m;
+
+    return G;
+}
+
+/* Construit le graphe CSR à partir d’un seul tableau d’arcs */
+CsrGraph csr_from_edges(int n, const EdgeList *E) {
+    return csr_from_edge_lists(n, E, 1);
+}
+
+/*
+   Tri par comptage avec validation : les tests de bornes et de signe se
+   font pendant le comptage des degrés, les doublons et les sommes de
+   lignes pendant le calcul final des offsets (une passe sur les lignes,
+   qui remplace csr_is_markov).
+*/
+CsrGraph csr_from_edges_checked(int n, const EdgeList *E, int merge_duplicates, LoadReport *R) {
+    LoadReport rep;
+    memset(&rep, 0, sizeof(rep));
+    rep.n = n;
+    rep.edges_read = E->size;
+    rep.merged = merge_duplicates;
+
+    // 1) degrés, bornes et signes
+    int64_t *deg = (int64_t*)calloc((size_t)n + 2, sizeof(int64_t));
+    if (!deg) {
+        perror("calloc degrees");
+        exit(EXIT_FAILURE);
+    }
+    int64_t m = 0;
+    for (int64_t i = 0; i < E->size; ++i) {
+        int u = E->from[i], v = E->to[i];
+        if (u < 1 || u > n || v < 1 || v > n) {
+            rep.out_of_range++;
+            continue;
+        }
+        if (E->prob[i] < 0) rep.negative++;
+        else if (E->prob[i] > 1) rep.above_one++;
+        deg[u + 1]++;
+        m++;
+    }
+
+    CsrGraph G = csr_alloc(n, m);
+    free(G.row);
+    G.row = deg;
+
+    // 2) somme préfixe, 3) remplissage par la fin (comme csr_from_edge_lists)
+    for (int u = 1; u <= n; ++u)
+        G.row[u + 1] += G.row[u];
+    for (int64_t i = 0; i < E->size; ++i) {
+        int u = E->from[i], v = E->to[i];
+        if (u < 1 || u > n || v < 1 || v > n) continue;
+        int64_t pos = --G.row[u + 1];
+        G.dest[pos] = v;
+        G.prob[pos] = E->prob[i];
+    }
+
+    // 4) offsets définitifs, ligne par ligne : somme, doublons, compactage
+    int64_t *seen = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+    if (!seen) {
+        perror("malloc seen");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v <= n; ++v) seen[v] = -1;
+
+    int64_t w = 0;
+    int bad_capacity = 0;
+    for (int u = 1; u <= n; ++u) {
+        int64_t begin = G.row[u + 1];
+        int64_t end = (u < n) ? G.row[u + 2] : m;
+        G.row[u] = w;
+        acc_t sum = 0;
+        for (int64_t k = begin; k < end; ++k) {
+            int v = G.dest[k];
+            sum += G.prob[k];
+            if (seen[v] >= G.row[u]) {
+                rep.duplicates++;
+                if (merge_duplicates) {
+                    G.prob[seen[v]] += G.prob[k];
+                    continue;
+                }
+            }
+            seen[v] = w;
+            G.dest[w] = v;
+            G.prob[w] = G.prob[k];
+            w++;
+        }
+
+        if (end == begin) rep.empty_rows++;
+        acc_t err = sum > 1 ? sum - 1 : 1 - sum;
+        if (err > rep.max_row_error) rep.max_row_error = err;
+        // tolérance de ±1% (comme csr_is_markov)
+        if (sum < 0.99f || sum > 1.01f) {
+            if (rep.bad_rows >= bad_capacity) {
+                bad_capacity = (bad_capacity < 8) ? 8 : bad_capacity * 2;
+                int   *nv = (int*)realloc(rep.bad_vertices, bad_capacity * sizeof(int));
+                acc_t *ns = (acc_t*)realloc(rep.bad_sums, bad_capacity * sizeof(acc_t));
+                if (!nv || !ns) {
+                    perror("realloc load report");
+                    exit(EXIT_FAILURE);
+                }
+                rep.bad_vertices = nv;
+                rep.bad_sums = ns;
+            }
+            rep.bad_vertices[rep.bad_rows] = u;
+            rep.bad_sums[rep.bad_rows] = sum;
+            rep.bad_rows++;
+        }
+    }
+    G.row[0] = 0;
+    G.row[n + 1] = w;
+    G.m = w;
+    free(seen);
+
+    rep.edges_kept = w;
+    rep.is_markov = (rep.bad_rows == 0 && rep.negative == 0 && rep.above_one == 0);
+    if (R) *R = rep;
+    else load_report_free(&rep);
+    return G;
+}
+
+/* Lecture avec validation dans la même passe (voir csr_from_edges_checked) */
+CsrGraph readGraphChecked(const char *filename, int merge_duplicates, LoadReport *R) {
+    EdgeList E;
+    int nbvert = load_edges(filename, 1, &E);
+    CsrGraph G = csr_from_edges_checked(nbvert, &E, merge_duplicates, R);
+    edges_free(&E);
+    return G;
+}
+
+/* Affiche le bilan de lecture : anomalies éventuelles, puis les sommets
+   non valides au format de csr_is_markov */
+void load_report_print(const LoadReport *R) {
+    if (R->duplicates > 0)
+        printf("%lld arcs en double%s\n", (long long)R->duplicates, R->merged ? " (fusionnes)" : "");
+    if (R->out_of_range > 0)
+        printf("%lld arcs hors de 1..%d ignores\n", (long long)R->out_of_range, R->n);
+    if (R->negative > 0 || R->above_one > 0)
+        printf("%lld probabilites negatives, %lld superieures a 1\n",
+               (long long)R->negative, (long long)R->above_one);
+    for (int i = 0; i < R->bad_rows; ++i)
+        printf("Sommet %d : somme = %.2f (non valide)\n", R->bad_vertices[i], R->bad_sums[i]);
+}
+
+void load_report_free(LoadReport *R) {
+    if (!R) return;
+    free(R->bad_vertices);
+    free(R->bad_sums);
+    R->bad_vertices = NULL;
+    R->bad_sums = NULL;
+}
+
+/* Convertit une liste d’adjacence en CSR (l’ordre des arcs est conservé) */
+CsrGraph csr_from_adj(const AdjList *G) {
+    int64_t m = 0;
+    for (int u = 1; u <= G->n; ++u)
+        for (const Cell *c = G->arr[u].head; c != NULL; c = c->next)
+            m++;
+
+    CsrGraph C = csr_alloc(G->n, m);
+    int64_t k = 0;
+    for (int u = 1; u <= G->n; ++u) {
+        C.row[u] = k;
+        for (const Cell *c = G->arr[u].head; c != NULL; c = c->next) {
+            C.dest[k] = c->dest;
+            C.prob[k] = c->prob;
+            k++;
+        }
+    }
+    C.row[G->n + 1] = k;
+    return C;
+}
+
+/* Graphe transposé : arcs entrants de chaque sommet (v -> u pour chaque u -> v) */
+CsrGraph csr_transpose(const CsrGraph *G) {
+    CsrGraph T = csr_alloc(G->n, G->m);
+
+    // degrés entrants, puis somme préfixe
+    for (int64_t k = 0; k < G->m; ++k)
+        T.row[G->dest[k] + 1]++;
+    for (int v = 1; v <= G->n; ++v)
+        T.row[v + 1] += T.row[v];
+
+    // même remplissage par la fin que csr_from_edge_lists
+    for (int u = G->n; u >= 1; --u) {
+        for (int64_t k = G->row[u + 1] - 1; k >= G->row[u]; --k) {
+            int64_t pos = --T.row[G->dest[k] + 1];
+            T.dest[pos] = u;
+            T.prob[pos] = G->prob[k];
+        }
+    }
+    for (int v = 0; v <= G->n; ++v)
+        T.row[v] = T.row[v + 1];
+    T.row[0] = 0;
+    T.row[G->n + 1] = G->m;
+
+    return T;
+}
+
+/* Lit un fichier texte et construit directement le graphe CSR */
+CsrGraph readGraphCSR(const char *filename) {
+    return readGraphFast(filename, 1);
+}
+
+/* Vérification Markov sur le graphe CSR (mêmes règles que adj_is_markov) */
+bool csr_is_markov(const CsrGraph *G) {
+    bool is_ok = true;
+
+    for (int u = 1; u <= G->n; ++u) {
+        acc_t sum = 0;
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k)
+            sum += G->prob[k];
+
+        // tolérance de ±1%
+        if (sum < 0.99f || sum > 1.01f) {
+            printf("Sommet %d : somme = %.2f (non valide)\n", u, sum);
+            is_ok = false;
+        }
+    }
+
+    return is_ok;
+}
+
+/* Libère les trois tableaux du graphe CSR (ou le bloc qui les contient) */
+void csr_free(CsrGraph *G) {
+    if (!G) return;
+    if (G->storage) {
+        if (G->release) G->release(G->storage);
+    } else {
+        free(G->row);
+        free(G->dest);
+        free(G->prob);
+    }
+    G->storage = NULL;
+    G->release = NULL;
+    G->row = NULL;
+    G->dest = NULL;
+    G->prob = NULL;
+    G->n = 0;
+    G->m = 0;
+}
+
+/* Convertit un entier en identifiant style A, B, C, AA, AB… (pour Mermaid),
+   écrit dans buf ; renvoie la longueur (0 et chaîne vide si buf est trop petit) */
+int getId_r(int num, char *buf, size_t size) {
+    char temp[GETID_SIZE];
     int i = 0;
-    char temp[8];
     num--; // passe en base 0
 
-    // conversion en lettres
-    while (num >= 0) {
+    // conversion en lettres (au plus 7 pour un int positif)
+    while (num >= 0 && i < GETID_SIZE) {
         temp[i++] = 'A' + (num % 26);
         num = num / 26 - 1;
     }
+    if ((size_t)i + 1 > size) {
+        if (size > 0) buf[0] = '\0';
+        return 0;
+    }
 
     // on remet dans le bon sens
     for (int j = 0; j < i; ++j)
-        buffer[j] = temp[i - j - 1];
+        buf[j] = temp[i - j - 1];
+    buf[i] = '\0';
+    return i;
+}
 
-    buffer[i] = '\0';
+/* Version à tampon interne (un par thread) */
+char *getId(int num) {
+    static _Thread_local char buffer[GETID_SIZE];
+    getId_r(num, buffer, sizeof(buffer));
     return buffer;
 }
 
-/* Génère un fichier Mermaid pour visualiser le graphe */
-void adj_to_mermaid(const AdjList *G, const char *filename) {
-    FILE *f = fopen(filename, "wt");
-    if (!f) {
+
+/* ---------- Export Mermaid ---------- */
+
+#define MERMAID_BUFFER (1 << 20)
+
+// Tampon de sortie vidé dans le fichier quand il est plein
+typedef struct {
+    FILE  *f;
+    char  *data;
+    size_t len;
+} OutBuf;
+
+static void out_flush(OutBuf *B) {
+    if (B->len > 0 && fwrite(B->data, 1, B->len, B->f) != B->len) {
+        perror("Could not write file");
+        exit(EXIT_FAILURE);
+    }
+    B->len = 0;
+}
+
+// Garantit la place pour bytes octets
+static inline void out_reserve(OutBuf *B, size_t bytes) {
+    if (B->len + bytes > MERMAID_BUFFER) out_flush(B);
+}
+
+static inline void out_str(OutBuf *B, const char *s, size_t len) {
+    out_reserve(B, len);
+    memcpy(B->data + B->len, s, len);
+    B->len += len;
+}
+
+static inline void out_id(OutBuf *B, int v) {
+    out_reserve(B, GETID_SIZE);
+    B->len += getId_r(v, B->data + B->len, GETID_SIZE);
+}
+
+static inline void out_int(OutBuf *B, long long x) {
+    char tmp[24];
+    int i = 0;
+    unsigned long long u = x < 0 ? 0ULL - (unsigned long long)x : (unsigned long long)x;
+    do {
+        tmp[i++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (x < 0) tmp[i++] = '-';
+    out_reserve(B, (size_t)i);
+    while (i > 0) B->data[B->len++] = tmp[--i];
+}
+
+/*
+   Probabilité avec deux décimales, comme "%.2f" : arrondi au plus proche
+   de la valeur binaire exacte, égalités vers le pair. Il faut que p * 100
+   soit exact : 24 + 7 bits tiennent dans un double pour un float, 53 + 7
+   bits demandent un long double d’au moins 60 bits de mantisse pour un
+   double. Sans lui (long double = double), ou si p * 100 ne tient pas
+   dans un long long (|p| >= 1e15, inf, nan), on passe par snprintf.
+*/
+#if MARKOV_PRECISION != MARKOV_DOUBLE
+typedef double scaled_prob;
+#define PROB2_EXACT 1
+#elif LDBL_MANT_DIG >= DBL_MANT_DIG + 7
+typedef long double scaled_prob;
+#define PROB2_EXACT 1
+#else
+#define PROB2_EXACT 0
+#endif
+
+// "%.2f" de la libc : jusqu’à 309 chiffres avant la virgule pour un double
+static void out_prob2_printf(OutBuf *B, prob_t p) {
+    char tmp[DBL_MAX_10_EXP + 8];
+    int len = snprintf(tmp, sizeof(tmp), "%.2f", (double)p);
+    out_str(B, tmp, (size_t)len);
+}
+
+static inline void out_prob2(OutBuf *B, prob_t p) {
+#if PROB2_EXACT
+    scaled_prob x = (scaled_prob)p * 100;
+    if (x < 0) x = -x;
+    if (!isfinite(x) || x >= 1e17) {
+        out_prob2_printf(B, p);
+        return;
+    }
+    long long c = (long long)x;
+    scaled_prob frac = x - (scaled_prob)c;
+    if (frac > 0.5 || (frac == 0.5 && (c & 1))) c++;
+    if (signbit(p)) out_str(B, "-", 1);
+    out_int(B, c / 100);
+    out_reserve(B, 3);
+    B->data[B->len++] = '.';
+    B->data[B->len++] = (char)('0' + (c / 10) % 10);
+    B->data[B->len++] = (char)('0' + c % 10);
+#else
+    out_prob2_printf(B, p);
+#endif
+}
+
+static OutBuf mermaid_open(const char *filename, int n) {
+    OutBuf B;
+    B.f = fopen(filename, "wt");
+    if (!B.f) {
         perror("Could not open file for writing");
         exit(EXIT_FAILURE);
     }
+    B.data = (char*)malloc(MERMAID_BUFFER);
+    if (!B.data) {
+        perror("malloc mermaid buffer");
+        exit(EXIT_FAILURE);
+    }
+    B.len = 0;
 
     // configuration Mermaid
-    fprintf(f, "---\n");
-    fprintf(f, "config:\n");
-    fprintf(f, "   layout: elk\n");
-    fprintf(f, "   theme: neo\n");
-    fprintf(f, "   look: neo\n");
-    fprintf(f, "---\n\n");
-    fprintf(f, "flowchart LR\n");
-
-    // déclaration des sommets
-    for (int u = 1; u <= G->n; ++u)
-        fprintf(f, "%s((%d))\n", getId(u), u);
+    static const char header[] =
+        "---\n"
+        "config:\n"
+        "   layout: elk\n"
+        "   theme: neo\n"
+        "   look: neo\n"
+        "---\n\n"
+        "flowchart LR\n";
+    out_str(&B, header, sizeof(header) - 1);
+
+    // déclaration des sommets : A((1))
+    for (int u = 1; u <= n; ++u) {
+        out_id(&B, u);
+        out_str(&B, "((", 2);
+        out_int(&B, u);
+        out_str(&B, "))\n", 3);
+    }
+    out_str(&B, "\n", 1);
+    return B;
+}
 
-    fprintf(f, "\n");
+// Arc : A -->|0.50|B (identifiant de u déjà calculé, une fois par ligne)
+static inline void mermaid_edge(OutBuf *B, const char *uid, int ulen, int v, prob_t p) {
+    out_str(B, uid, (size_t)ulen);
+    out_str(B, " -->|", 5);
+    out_prob2(B, p);
+    out_str(B, "|", 1);
+    out_id(B, v);
+    out_str(B, "\n", 1);
+}
+
+static void mermaid_close(OutBuf *B) {
+    out_flush(B);
+    free(B->data);
+    if (fclose(B->f) != 0) {
+        perror("Could not write file");
+        exit(EXIT_FAILURE);
+    }
+}
 
-    // déclaration des arcs
+/* Génère un fichier Mermaid pour visualiser le graphe */
+void adj_to_mermaid(const AdjList *G, const char *filename) {
+    OutBuf B = mermaid_open(filename, G->n);
+    char uid[GETID_SIZE];
     for (int u = 1; u <= G->n; ++u) {
-        const Cell *cur = G->arr[u].head;
-        while (cur) {
-            fprintf(f, "%s -->|%.2f|%s\n",
-                    getId(u), cur->prob, getId(cur->dest));
-            cur = cur->next;
-        }
+        int ulen = getId_r(u, uid, sizeof(uid));
+        for (const Cell *cur = G->arr[u].head; cur; cur = cur->next)
+            mermaid_edge(&B, uid, ulen, cur->dest, cur->prob);
     }
+    mermaid_close(&B);
+}
 
-    fclose(f);
+/* Même export depuis le graphe CSR */
+void csr_to_mermaid(const CsrGraph *G, const char *filename) {
+    OutBuf B = mermaid_open(filename, G->n);
+    char uid[GETID_SIZE];
+    for (int u = 1; u <= G->n; ++u) {
+        int ulen = getId_r(u, uid, sizeof(uid));
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k)
+            mermaid_edge(&B, uid, ulen, G->dest[k], G->prob[k]);
+    }
+    mermaid_close(&B);
 }
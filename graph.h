@@ -4,11 +4,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "numeric.h"
+#include "arena.h"
 
 // Maillon d’une liste
 typedef struct Cell {
     int dest;              // sommet d’arrivée
-    float prob;            // probabilité de transition
+    prob_t prob;           // probabilité de transition
     struct Cell *next;     // maillon suivant
 } Cell;
 
@@ -21,31 +24,107 @@ typedef struct {
 typedef struct {
     int n;                 // nombre de sommets
     List *arr;             // tableau de n listes
+    Arena *arena;          // bloc des cellules (NULL : un malloc par cellule)
 } AdjList;
 
+// Graphe orienté au format CSR (Compressed Sparse Row) :
+// les arcs sortants de u sont contigus dans dest/prob[row[u] .. row[u+1]-1]
+typedef struct {
+    int      n;            // nombre de sommets (indexés de 1 à n)
+    int64_t  m;            // nombre d’arcs
+    int64_t *row;          // n+2 offsets (row[1] = 0, row[n+1] = m)
+    int     *dest;         // sommets d’arrivée (m valeurs)
+    prob_t  *prob;         // probabilités de transition (m valeurs)
+    void    *storage;      // bloc externe contenant les tableaux (NULL : malloc)
+    void   (*release)(void *storage); // libère ce bloc dans csr_free
+} CsrGraph;
+
+// Tableau dynamique d’arcs (u, v, p), dans l’ordre de lecture
+typedef struct {
+    int     *from;
+    int     *to;
+    prob_t  *prob;
+    int64_t  size;
+    int64_t  capacity;
+} EdgeList;
+
+// Bilan de la validation faite pendant la lecture (readGraphChecked)
+typedef struct {
+    int     n;               // nombre de sommets annoncé
+    int64_t edges_read;      // triplets lus
+    int64_t edges_kept;      // arcs du graphe final
+    int64_t out_of_range;    // arcs dont un sommet sort de 1..n (ignorés)
+    int64_t negative;        // probabilités < 0
+    int64_t above_one;       // probabilités > 1
+    int64_t duplicates;      // arcs (u, v) répétés
+    int     merged;          // 1 : doublons fusionnés (probabilités sommées)
+    int     empty_rows;      // sommets sans arc sortant
+    int     bad_rows;        // sommets dont la somme sort de [0.99, 1.01]
+    int    *bad_vertices;    // ces sommets (bad_rows valeurs, croissants)
+    acc_t  *bad_sums;        // et leurs sommes
+    acc_t   max_row_error;   // max |somme - 1| sur les sommets
+    bool    is_markov;       // aucune ligne fautive, aucune probabilité hors [0, 1]
+} LoadReport;
+
 // Création et manipulation des listes
-Cell*  make_cell(int dest, float prob);
+Cell*  make_cell(int dest, prob_t prob);
 List   make_list(void);
-void   list_push_front(List *L, int dest, float prob);
+void   list_push_front(List *L, int dest, prob_t prob);
 void   list_print(const List *L);
 
 // Création et manipulation de la liste d’adjacence
 AdjList adj_create(int n);                      // crée n listes vides
-void    adj_add_edge(AdjList *G, int u, int v, float p); // ajoute arête
+AdjList adj_create_pooled(int n, int64_t edges); // idem, cellules dans une arène
+void    adj_add_edge(AdjList *G, int u, int v, prob_t p); // ajoute arête
 void    adj_print(const AdjList *G);            // affichage format demandé
-void    adj_free(AdjList *G);                   // libération mémoire
+void    adj_free(AdjList *G);                   // libération mémoire (O(blocs) si arène)
 
 // Lecture depuis un fichier texte (format du sujet)
 AdjList readGraph(const char *filename);
 
+// Liste d’adjacence depuis un graphe CSR (mêmes listes que readGraph pour
+// un CSR construit par csr_from_edges) ; pooled : cellules dans une arène
+AdjList adj_from_csr(const CsrGraph *G, int pooled);
+
 // Vérifie que la somme des probabilités sortantes de chaque sommet ≈ 1
 bool adj_is_markov(const AdjList *G);
 
 
+// Tableau d’arcs
+EdgeList edges_create(void);
+void     edges_push(EdgeList *E, int u, int v, prob_t p);
+void     edges_free(EdgeList *E);
+
+// Construction et manipulation du graphe CSR
+CsrGraph csr_from_edges(int n, const EdgeList *E); // tri par comptage des arcs
+CsrGraph csr_from_edge_lists(int n, const EdgeList *lists, int count);
+CsrGraph csr_from_adj(const AdjList *G);           // même ordre d’arcs que G
+// Même construction, avec la validation en cours de route : arcs hors
+// bornes ignorés, probabilités hors [0, 1] et doublons comptés (doublons
+// fusionnés si merge_duplicates), sommes des lignes vérifiées pendant le
+// calcul des offsets. R peut être NULL.
+CsrGraph csr_from_edges_checked(int n, const EdgeList *E, int merge_duplicates, LoadReport *R);
+CsrGraph readGraphChecked(const char *filename, int merge_duplicates, LoadReport *R);
+void     load_report_print(const LoadReport *R);
+void     load_report_free(LoadReport *R);
+CsrGraph csr_transpose(const CsrGraph *G);         // arcs entrants (v -> u)
+CsrGraph readGraphCSR(const char *filename);       // lecture directe en CSR
+bool     csr_is_markov(const CsrGraph *G);
+void     csr_free(CsrGraph *G);
+
+
 // Convertit un numéro de sommet (1,2,3,...) en identifiant (A,B,C,...,AA,...)
+// getId_r écrit dans buf (GETID_SIZE octets suffisent pour tout int) et
+// renvoie la longueur. getId renvoie un tampon propre au thread, écrasé à
+// l’appel suivant : ne pas l’appeler deux fois dans la même expression.
+#define GETID_SIZE 16
+int   getId_r(int num, char *buf, size_t size);
 char *getId(int num);
 
-// Produit un fichier texte Mermaid pour visualiser le graphe
+// Produit un fichier texte Mermaid pour visualiser le graphe (sortie
+// formatée à la main dans un tampon vidé par blocs, sans état partagé :
+// plusieurs exports peuvent tourner en parallèle)
 void adj_to_mermaid(const AdjList *G, const char *filename);
+void csr_to_mermaid(const CsrGraph *G, const char *filename);
 
 #endif // GRAPH_H
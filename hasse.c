@@ -1,4 +1,10 @@
 #include "hasse.h"
+#include "reach.h"
+#include <string.h>
+
+// Mémoire maximale des ensembles d'accessibilité d'une passe (octets) :
+// au-delà, les classes cibles sont traitées par tranches
+#define HASSE_BITSET_BUDGET ((size_t)64 << 20)
 
 /*
    Supprime les liens transitifs du diagramme de Hasse
@@ -14,8 +20,11 @@ void removeTransitiveLinks(t_link_array *p_link_array) {
     if (!p_link_array || p_link_array->size <= 2) return;
 
     int n = p_link_array->size;
-    int to_remove[n];
-    for (int i = 0; i < n; ++i) to_remove[i] = 0;   // marqueurs de suppression
+    int *to_remove = (int*)calloc(n, sizeof(int));   // marqueurs de suppression
+    if (!to_remove) {
+        perror("calloc to_remove");
+        exit(EXIT_FAILURE);
+    }
 
     /*
        Triple boucle :
@@ -53,4 +62,141 @@ void removeTransitiveLinks(t_link_array *p_link_array) {
     }
 
     p_link_array->size = new_size; // mise à jour du nombre final de liens
+    free(to_remove);
+}
+
+
+/*
+   Réduction transitive exacte du graphe des classes (un DAG).
+
+   1) ordre topologique des classes (Kahn) ;
+   2) on parcourt les classes dans l'ordre topologique inverse : reach[u] est
+      l'ensemble (bitset) des classes accessibles depuis u. Les successeurs
+      directs de u sont visités du plus proche au plus lointain dans l'ordre
+      topologique ; un lien u -> v est transitif si v est déjà dans l'union
+      des reach[w] des successeurs w visités avant lui (seul un w placé avant
+      v peut atteindre v). Les liens en double sont éliminés au passage.
+
+   Les bitsets coûtent nb_classes × tranche / 8 octets : si la matrice
+   complète dépasse HASSE_BITSET_BUDGET, les classes cibles sont découpées
+   en tranches de colonnes et l'étape 2 est refaite pour chaque tranche.
+   Coût : O((C + L) × C / 64) opérations sur des mots de 64 bits.
+*/
+void transitiveReduction(t_link_array *p_link_array, int nb_classes) {
+    if (!p_link_array || p_link_array->size <= 1) return;
+
+    int L = p_link_array->size;
+    const t_link *links = p_link_array->data;
+    if (nb_classes <= 0) {
+        for (int i = 0; i < L; ++i) {
+            if (links[i].from >= nb_classes) nb_classes = links[i].from + 1;
+            if (links[i].to >= nb_classes) nb_classes = links[i].to + 1;
+        }
+    }
+    int C = nb_classes;
+
+    // liens sortants de chaque classe (CSR), en gardant l'indice du lien
+    int *start = (int*)calloc((size_t)C + 1, sizeof(int));
+    int *succ = (int*)malloc(L * sizeof(int));      // indices de liens
+    int *indeg = (int*)calloc(C, sizeof(int));
+    int *topo = (int*)malloc(C * sizeof(int));      // classes dans l'ordre topologique
+    int *rank = (int*)malloc(C * sizeof(int));      // position dans topo
+    char *drop = (char*)calloc(L, 1);
+    if (!start || !succ || !indeg || !topo || !rank || !drop) {
+        perror("malloc transitive reduction");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < L; ++i) {
+        start[links[i].from + 1]++;
+        indeg[links[i].to]++;
+    }
+    for (int c = 0; c < C; ++c) start[c + 1] += start[c];
+    int *fill = (int*)malloc(C * sizeof(int));
+    if (!fill) {
+        perror("malloc transitive reduction");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, start, C * sizeof(int));
+    for (int i = 0; i < L; ++i) succ[fill[links[i].from]++] = i;
+
+    // 1) ordre topologique
+    int head = 0, tail = 0;
+    for (int c = 0; c < C; ++c)
+        if (indeg[c] == 0) topo[tail++] = c;
+    while (head < tail) {
+        int u = topo[head++];
+        for (int k = start[u]; k < start[u + 1]; ++k)
+            if (--indeg[links[succ[k]].to] == 0) topo[tail++] = links[succ[k]].to;
+    }
+    if (tail < C) {
+        fprintf(stderr, "transitiveReduction : le graphe des classes contient un cycle\n");
+        free(start); free(succ); free(indeg); free(topo); free(rank); free(drop); free(fill);
+        return;
+    }
+    for (int t = 0; t < C; ++t) rank[topo[t]] = t;
+
+    // successeurs de chaque classe triés par rang topologique croissant
+    // (tri par comptage global sur le rang de la cible)
+    int *cnt = indeg;   // tous nuls après Kahn, réutilisé comme compteur
+    memset(cnt, 0, C * sizeof(int));
+    for (int i = 0; i < L; ++i) cnt[rank[links[i].to]]++;
+    for (int t = 1; t < C; ++t) cnt[t] += cnt[t - 1];
+    int *by_rank = (int*)malloc(L * sizeof(int));
+    if (!by_rank) {
+        perror("malloc transitive reduction");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = L - 1; i >= 0; --i) by_rank[--cnt[rank[links[i].to]]] = i;
+    memcpy(fill, start, C * sizeof(int));
+    for (int k = 0; k < L; ++k) succ[fill[links[by_rank[k]].from]++] = by_rank[k];
+    free(by_rank);
+
+    // 2) accessibilité par tranches de classes cibles
+    size_t words_all = ((size_t)C + 63) / 64;
+    size_t words = HASSE_BITSET_BUDGET / ((size_t)C * sizeof(uint64_t));
+    if (words < 1) words = 1;
+    if (words > words_all) words = words_all;
+    uint64_t *reach = (uint64_t*)malloc((size_t)C * words * sizeof(uint64_t));
+    if (!reach) {
+        perror("malloc reach");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t w0 = 0; w0 < words_all; w0 += words) {
+        size_t nw = (w0 + words <= words_all) ? words : words_all - w0;
+        int lo = (int)(w0 * 64);                          // première classe de la tranche
+        int hi = (int)((w0 + nw) * 64 < (size_t)C ? (w0 + nw) * 64 : (size_t)C);
+
+        for (int t = C - 1; t >= 0; --t) {
+            int u = topo[t];
+            uint64_t *ru = reach + (size_t)u * nw;
+            memset(ru, 0, nw * sizeof(uint64_t));
+            for (int k = start[u]; k < start[u + 1]; ++k) {
+                int v = links[succ[k]].to;
+                int in = (v >= lo && v < hi);
+                uint64_t bit = 1ULL << ((v - lo) & 63);
+                if (in && (ru[(v - lo) >> 6] & bit)) {
+                    drop[succ[k]] = 1;   // déjà accessible : lien transitif (ou doublon)
+                    continue;
+                }
+                bitset_or(ru, reach + (size_t)v * nw, nw);
+                if (in) ru[(v - lo) >> 6] |= bit;
+            }
+        }
+    }
+
+    // compactage dans l'ordre d'origine
+    int new_size = 0;
+    for (int i = 0; i < L; ++i)
+        if (!drop[i]) p_link_array->data[new_size++] = links[i];
+    p_link_array->size = new_size;
+
+    free(reach);
+    free(fill);
+    free(drop);
+    free(rank);
+    free(topo);
+    free(indeg);
+    free(succ);
+    free(start);
 }
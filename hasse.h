@@ -18,6 +18,13 @@ typedef struct {
 } t_link_array;
 
 // Fonction (optionnelle) pour retirer les liens transitifs
+// (chemins de longueur 2 seulement, O(L^3) : préférer transitiveReduction)
 void removeTransitiveLinks(t_link_array *p_link_array);
 
+// Réduction transitive exacte du graphe des classes (DAG) : ordre
+// topologique + accessibilité par bitsets, O((C + L) × C / 64).
+// nb_classes <= 0 : déduit des indices des liens. L'ordre des liens
+// conservés est inchangé ; le tableau est laissé intact s'il y a un cycle.
+void transitiveReduction(t_link_array *p_link_array, int nb_classes);
+
 #endif // HASSE_H
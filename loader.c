@@ -0,0 +1,720 @@
+#include "loader.h"
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#else
+#include <io.h>
+#endif
+
+// ============================================================================
+//  Projection du fichier en mémoire
+// ============================================================================
+
+// Repli portable : lit tout le fichier dans un buffer qui double. Pas de
+// fseek/ftell : le fichier peut être un tube (FIFO, <(...), /dev/stdin)
+static MappedFile read_whole_file(const char *filename) {
+    MappedFile F = { NULL, 0, 0 };
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        perror("Could not open file for reading");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t capacity = 1 << 16;
+    char *buf = (char*)malloc(capacity);
+    if (!buf) {
+        perror("malloc file buffer");
+        exit(EXIT_FAILURE);
+    }
+    size_t got;
+    while ((got = fread(buf + F.size, 1, capacity - F.size, f)) > 0) {
+        F.size += got;
+        if (F.size < capacity) continue;
+        char *nb = (char*)realloc(buf, capacity * 2);
+        if (!nb) {
+            perror("realloc file buffer");
+            exit(EXIT_FAILURE);
+        }
+        buf = nb;
+        capacity *= 2;
+    }
+    if (ferror(f)) {
+        perror("Could not read file");
+        exit(EXIT_FAILURE);
+    }
+    F.data = buf;
+    fclose(f);
+    return F;
+}
+
+MappedFile mapped_file_open(const char *filename) {
+#ifdef _WIN32
+    return read_whole_file(filename);
+#else
+    MappedFile F = { NULL, 0, 0 };
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Could not open file for reading");
+        exit(EXIT_FAILURE);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        // pas un fichier régulier (ou vide) : on ne peut pas projeter
+        close(fd);
+        return read_whole_file(filename);
+    }
+
+    // copie privée : une écriture (ex. dans un graphe projeté par
+    // readChainBinary) duplique la page touchée sans modifier le fichier
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // la projection reste valide après close
+    if (p == MAP_FAILED) {
+        return read_whole_file(filename);
+    }
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    F.data = (const char*)p;
+    F.size = (size_t)st.st_size;
+    F.mapped = 1;
+    return F;
+#endif
+}
+
+void mapped_file_close(MappedFile *F) {
+    if (!F || !F->data) return;
+#ifndef _WIN32
+    if (F->mapped)
+        munmap((void*)F->data, F->size);
+    else
+#endif
+        free((void*)F->data);
+    F->data = NULL;
+    F->size = 0;
+    F->mapped = 0;
+}
+
+
+// ============================================================================
+//  Analyseur lexical (pas de copie, pas de locale)
+// ============================================================================
+
+static inline int is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static inline int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline const char *skip_spaces(const char *p, const char *end) {
+    while (p < end && is_space(*p)) p++;
+    return p;
+}
+
+// Lit un entier signé ; renvoie NULL si aucun chiffre ou si la valeur
+// absolue dépasse INT_MAX (jeton invalide, comme un triplet mal formé)
+static const char *scan_int(const char *p, const char *end, int *out) {
+    p = skip_spaces(p, end);
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+    if (p >= end || !is_digit(*p)) return NULL;
+
+    int v = 0;
+    while (p < end && is_digit(*p)) {
+        int d = *p - '0';
+        if (v > (INT_MAX - d) / 10) return NULL;
+        v = v * 10 + d;
+        p++;
+    }
+    *out = neg ? -v : v;
+    return p;
+}
+
+// Lit un réel (123, 0.25, .5, 1e-3) ; renvoie NULL si aucun chiffre
+static const char *scan_float(const char *p, const char *end, prob_t *out) {
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+    };
+
+    p = skip_spaces(p, end);
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+
+    unsigned long long mant = 0;
+    int ndigits = 0;   // chiffres significatifs gardés dans mant
+    int exp10 = 0;     // exposant décimal à appliquer à mant
+    int any = 0;
+
+    while (p < end && is_digit(*p)) {
+        if (ndigits < 18) { mant = mant * 10 + (*p - '0'); ndigits++; }
+        else exp10++;
+        p++;
+        any = 1;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && is_digit(*p)) {
+            if (ndigits < 18) { mant = mant * 10 + (*p - '0'); ndigits++; exp10--; }
+            p++;
+            any = 1;
+        }
+    }
+    if (!any) return NULL;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        int eneg = 0, e = 0;
+        if (q < end && (*q == '-' || *q == '+')) {
+            eneg = (*q == '-');
+            q++;
+        }
+        if (q < end && is_digit(*q)) {
+            while (q < end && is_digit(*q)) {
+                if (e < 1000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    double v = (double)mant;
+    while (exp10 > 18)  { v *= 1e18; exp10 -= 18; }
+    while (exp10 < -18) { v /= 1e18; exp10 += 18; }
+    v = (exp10 >= 0) ? v * pow10[exp10] : v / pow10[-exp10];
+
+    *out = (prob_t)(neg ? -v : v);
+    return p;
+}
+
+// Lit les triplets "u v p" de [p, end) jusqu’au premier triplet invalide.
+// Renvoie 1 si toute la zone a été lue, 0 si la lecture s’est arrêtée avant.
+static int scan_edges(const char *p, const char *end, EdgeList *E) {
+    int u, v;
+    prob_t prob;
+    while (1) {
+        const char *q = scan_int(p, end, &u);
+        if (q) q = scan_int(q, end, &v);
+        if (q) q = scan_float(q, end, &prob);
+        if (!q) break;
+        edges_push(E, u, v, prob);
+        p = q;
+    }
+    return skip_spaces(p, end) == end;
+}
+
+
+// ============================================================================
+//  Lecture multi-thread : un morceau de fichier par thread
+// ============================================================================
+
+// Taille minimale d’un morceau (en dessous, un seul thread suffit)
+#define LOADER_MIN_CHUNK (1 << 20)
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    EdgeList    edges;
+    int         complete;  // 1 si le morceau a été lu jusqu’au bout
+} LoadChunk;
+
+static void *load_chunk_worker(void *arg) {
+    LoadChunk *C = (LoadChunk*)arg;
+    C->complete = scan_edges(C->begin, C->end, &C->edges);
+    return NULL;
+}
+
+// Avance jusqu’au début de la ligne suivante
+static const char *next_line(const char *p, const char *end) {
+    while (p < end && *p != '\n') p++;
+    return (p < end) ? p + 1 : end;
+}
+
+// Découpe et lit le fichier ; renvoie le nombre de sommets.
+// *out_chunks est alloué (un tableau d’arcs par morceau, dans l’ordre).
+static int load_chunks(const MappedFile *F, int nthreads,
+                       LoadChunk **out_chunks, int *out_count) {
+    const char *p = F->data;
+    const char *end = F->data + F->size;
+
+    int nbvert;
+    p = scan_int(p, end, &nbvert);
+    if (!p) {
+        fprintf(stderr, "Could not read number of vertices\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t body = (size_t)(end - p);
+    if (nthreads < 1) nthreads = 1;
+    if ((size_t)nthreads > body / LOADER_MIN_CHUNK + 1)
+        nthreads = (int)(body / LOADER_MIN_CHUNK + 1);
+
+    LoadChunk *chunks = (LoadChunk*)calloc(nthreads, sizeof(LoadChunk));
+    if (!chunks) {
+        perror("calloc chunks");
+        exit(EXIT_FAILURE);
+    }
+
+    // bornes des morceaux, recalées sur des fins de ligne
+    const char *cur = p;
+    for (int t = 0; t < nthreads; ++t) {
+        const char *stop = (t == nthreads - 1) ? end
+                         : next_line(p + body * (t + 1) / nthreads, end);
+        if (stop < cur) stop = cur;
+        chunks[t].begin = cur;
+        chunks[t].end = stop;
+        chunks[t].edges = edges_create();
+        cur = stop;
+    }
+
+    if (nthreads == 1) {
+        load_chunk_worker(&chunks[0]);
+    } else {
+        pthread_t *th = (pthread_t*)malloc(nthreads * sizeof(pthread_t));
+        if (!th) {
+            perror("malloc threads");
+            exit(EXIT_FAILURE);
+        }
+        for (int t = 0; t < nthreads; ++t) {
+            if (pthread_create(&th[t], NULL, load_chunk_worker, &chunks[t]) != 0) {
+                perror("pthread_create");
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (int t = 0; t < nthreads; ++t)
+            pthread_join(th[t], NULL);
+        free(th);
+    }
+
+    // comme fscanf : tout s’arrête au premier triplet invalide
+    int count = nthreads;
+    for (int t = 0; t < nthreads; ++t) {
+        if (!chunks[t].complete) {
+            count = t + 1;
+            break;
+        }
+    }
+    for (int t = count; t < nthreads; ++t)
+        edges_free(&chunks[t].edges);
+
+    *out_chunks = chunks;
+    *out_count = count;
+    return nbvert;
+}
+
+int load_edges(const char *filename, int nthreads, EdgeList *E) {
+    if (strcmp(filename, "-") == 0) return load_edges_stream(stdin, E);
+    MappedFile F = mapped_file_open(filename);
+    LoadChunk *chunks;
+    int count;
+    int nbvert = load_chunks(&F, nthreads, &chunks, &count);
+    mapped_file_close(&F);
+
+    // le premier morceau devient le résultat, les autres y sont recopiés
+    *E = chunks[0].edges;
+    for (int t = 1; t < count; ++t) {
+        const EdgeList *S = &chunks[t].edges;
+        for (int64_t i = 0; i < S->size; ++i)
+            edges_push(E, S->from[i], S->to[i], S->prob[i]);
+        edges_free(&chunks[t].edges);
+    }
+    free(chunks);
+    return nbvert;
+}
+
+CsrGraph readGraphFast(const char *filename, int nthreads) {
+    if (strcmp(filename, "-") == 0) return readGraphStream(stdin);
+    MappedFile F = mapped_file_open(filename);
+    LoadChunk *chunks;
+    int count;
+    int nbvert = load_chunks(&F, nthreads, &chunks, &count);
+    mapped_file_close(&F);
+
+    // fusion : le tri par comptage lit directement les tableaux de chaque thread
+    EdgeList *lists = (EdgeList*)malloc(count * sizeof(EdgeList));
+    if (!lists) {
+        perror("malloc edge lists");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < count; ++t)
+        lists[t] = chunks[t].edges;
+
+    CsrGraph G = csr_from_edge_lists(nbvert, lists, count);
+
+    for (int t = 0; t < count; ++t)
+        edges_free(&lists[t]);
+    free(lists);
+    free(chunks);
+    return G;
+}
+
+
+// ============================================================================
+//  Lecture en flux : blocs de texte analysés au fur et à mesure
+// ============================================================================
+
+// Source : un FILE* ou un descripteur
+typedef struct {
+    FILE *f;
+    int   fd;
+} StreamSource;
+
+// Lit jusqu’à cap octets ; 0 en fin de flux (arrêt sur erreur de lecture)
+static size_t stream_read(StreamSource *S, char *buf, size_t cap) {
+    if (S->f) {
+        size_t got = fread(buf, 1, cap, S->f);
+        if (got == 0 && ferror(S->f)) {
+            perror("Could not read stream");
+            exit(EXIT_FAILURE);
+        }
+        return got;
+    }
+    while (1) {
+#ifdef _WIN32
+        long got = _read(S->fd, buf, (unsigned)cap);
+#else
+        ssize_t got = read(S->fd, buf, cap);
+        if (got < 0 && errno == EINTR) continue;
+#endif
+        if (got < 0) {
+            perror("Could not read stream");
+            exit(EXIT_FAILURE);
+        }
+        return (size_t)got;
+    }
+}
+
+// Jetons suivants de [p, end), tous complets (end tombe sur un blanc ou en
+// fin de flux). Renvoie le début du premier triplet non lu : coupé par end,
+// ou invalide (*bad = 1).
+static const char *scan_stream_edges(const char *p, const char *end, EdgeList *E, int *bad) {
+    int u, v;
+    prob_t prob;
+    while (1) {
+        const char *q = p;
+        if (skip_spaces(q, end) == end) return p;
+        if (!(q = scan_int(q, end, &u))) break;
+        if (skip_spaces(q, end) == end) return p;
+        if (!(q = scan_int(q, end, &v))) break;
+        if (skip_spaces(q, end) == end) return p;
+        if (!(q = scan_float(q, end, &prob))) break;
+        edges_push(E, u, v, prob);
+        p = q;
+    }
+    *bad = 1;
+    return p;
+}
+
+static int load_stream(StreamSource *S, EdgeList *E) {
+    size_t cap = LOADER_STREAM_CHUNK, len = 0;
+    char *buf = (char*)malloc(cap);
+    if (!buf) {
+        perror("malloc stream buffer");
+        exit(EXIT_FAILURE);
+    }
+
+    int nbvert = -1, eof = 0, bad = 0;
+    while (!eof && !bad) {
+        if (len == cap) {
+            // un seul jeton remplit le bloc : on l’agrandit
+            cap *= 2;
+            char *nb = (char*)realloc(buf, cap);
+            if (!nb) {
+                perror("realloc stream buffer");
+                exit(EXIT_FAILURE);
+            }
+            buf = nb;
+        }
+        size_t got = stream_read(S, buf + len, cap - len);
+        if (got == 0) eof = 1;
+        len += got;
+
+        // zone sûre : jusqu’au dernier blanc, ou tout le bloc en fin de flux
+        const char *end = buf + len;
+        if (!eof) {
+            while (end > buf && !is_space(end[-1])) end--;
+            if (end == buf) continue;
+        }
+
+        const char *p = buf;
+        if (nbvert < 0) {
+            if (skip_spaces(p, end) == end) {
+                if (!eof) continue;
+                break;
+            }
+            p = scan_int(p, end, &nbvert);
+            if (!p) break;
+        }
+        p = scan_stream_edges(p, end, E, &bad);
+
+        // le reste (triplet coupé) repasse en tête du bloc
+        len = (size_t)(buf + len - p);
+        memmove(buf, p, len);
+    }
+    free(buf);
+
+    if (nbvert < 0) {
+        fprintf(stderr, "Could not read number of vertices\n");
+        exit(EXIT_FAILURE);
+    }
+    return nbvert;
+}
+
+int load_edges_stream(FILE *f, EdgeList *E) {
+    StreamSource S = { f, -1 };
+    *E = edges_create();
+    return load_stream(&S, E);
+}
+
+int load_edges_fd(int fd, EdgeList *E) {
+    StreamSource S = { NULL, fd };
+    *E = edges_create();
+    return load_stream(&S, E);
+}
+
+CsrGraph readGraphStream(FILE *f) {
+    EdgeList E;
+    int nbvert = load_edges_stream(f, &E);
+    CsrGraph G = csr_from_edges(nbvert, &E);
+    edges_free(&E);
+    return G;
+}
+
+CsrGraph readGraphFd(int fd) {
+    EdgeList E;
+    int nbvert = load_edges_fd(fd, &E);
+    CsrGraph G = csr_from_edges(nbvert, &E);
+    edges_free(&E);
+    return G;
+}
+
+
+// ============================================================================
+//  Format binaire (sauvegarde / projection)
+// ============================================================================
+
+typedef struct {
+    char     magic[8];     // "MKVCHAIN"
+    uint32_t version;      // CHAIN_VERSION
+    uint32_t endian;       // 0x01020304 dans l’ordre de la machine d’écriture
+    uint32_t prob_size;    // sizeof(prob_t) : 4 (float, mixed) ou 8 (double)
+    uint32_t flags;        // bit 0 : partition présente
+    int64_t  n;            // nombre de sommets
+    int64_t  m;            // nombre d’arcs
+    int64_t  nclasses;     // nombre de classes (0 si pas de partition)
+    char     reserved[16];
+} ChainHeader;             // 64 octets
+
+#define CHAIN_ENDIAN        0x01020304u
+#define CHAIN_HAS_PARTITION 1u
+
+// Taille arrondie au multiple de 8 supérieur
+static size_t align8(size_t x) {
+    return (x + 7) & ~(size_t)7;
+}
+
+// Écrit un bloc brut
+static void write_bytes(FILE *f, const void *data, size_t bytes) {
+    if (bytes && fwrite(data, 1, bytes, f) != bytes) {
+        perror("write chain");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Complète par des zéros une section de `bytes` octets jusqu’au multiple de 8
+static void write_padding(FILE *f, size_t bytes) {
+    static const char zeros[8] = { 0 };
+    write_bytes(f, zeros, align8(bytes) - bytes);
+}
+
+// Écrit un bloc puis l’aligne sur 8 octets
+static void write_section(FILE *f, const void *data, size_t bytes) {
+    write_bytes(f, data, bytes);
+    write_padding(f, bytes);
+}
+
+void saveChainBinary(const char *filename, const CsrGraph *G, const TarjanPartition *P) {
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        perror("Could not open file for writing");
+        exit(EXIT_FAILURE);
+    }
+
+    ChainHeader H;
+    memset(&H, 0, sizeof(H));
+    memcpy(H.magic, CHAIN_MAGIC, sizeof(H.magic));
+    H.version = CHAIN_VERSION;
+    H.endian = CHAIN_ENDIAN;
+    H.prob_size = sizeof(prob_t);
+    H.flags = (P && P->size > 0) ? CHAIN_HAS_PARTITION : 0;
+    H.n = G->n;
+    H.m = G->m;
+    H.nclasses = (H.flags & CHAIN_HAS_PARTITION) ? P->size : 0;
+    write_section(f, &H, sizeof(H));
+
+    write_section(f, G->row, ((size_t)G->n + 2) * sizeof(int64_t));
+    write_section(f, G->dest, (size_t)G->m * sizeof(int));
+    write_section(f, G->prob, (size_t)G->m * sizeof(prob_t));
+
+    if (H.flags & CHAIN_HAS_PARTITION) {
+        // partition à plat : offsets des classes puis membres à la suite
+        int64_t *offsets = (int64_t*)malloc(((size_t)P->size + 1) * sizeof(int64_t));
+        if (!offsets) {
+            perror("malloc partition offsets");
+            exit(EXIT_FAILURE);
+        }
+        offsets[0] = 0;
+        for (int c = 0; c < P->size; ++c)
+            offsets[c + 1] = offsets[c] + P->classes[c].size;
+        write_section(f, offsets, ((size_t)P->size + 1) * sizeof(int64_t));
+
+        for (int c = 0; c < P->size; ++c)
+            write_bytes(f, P->classes[c].members, (size_t)P->classes[c].size * sizeof(int));
+        write_padding(f, (size_t)offsets[P->size] * sizeof(int));
+        free(offsets);
+    }
+
+    if (fclose(f) != 0) {
+        perror("close chain");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Libère le fichier projeté qui porte les tableaux du graphe
+static void release_mapped_chain(void *storage) {
+    MappedFile *F = (MappedFile*)storage;
+    mapped_file_close(F);
+    free(F);
+}
+
+// Vérifie qu’une section [off, off+bytes) tient dans le fichier
+static size_t chain_section(const MappedFile *F, size_t *off, size_t bytes, const char *what) {
+    size_t start = *off;
+    if (start + bytes > F->size || start + bytes < start) {
+        fprintf(stderr, "Chain file truncated (%s)\n", what);
+        exit(EXIT_FAILURE);
+    }
+    *off = start + align8(bytes);
+    return start;
+}
+
+// Refuse un fichier dont une section est incohérente
+static void chain_reject(const char *what, const char *filename) {
+    fprintf(stderr, "Unsupported chain file (bad %s): %s\n", what, filename);
+    exit(EXIT_FAILURE);
+}
+
+// row croissant de 0 à m, destinations dans 1..n
+static void check_chain_graph(const CsrGraph *G, const char *filename) {
+    if (G->row[0] != 0 || G->row[G->n + 1] != G->m) chain_reject("row", filename);
+    for (int u = 0; u <= G->n; ++u)
+        if (G->row[u] > G->row[u + 1]) chain_reject("row", filename);
+    for (int64_t e = 0; e < G->m; ++e)
+        if (G->dest[e] < 1 || G->dest[e] > G->n) chain_reject("dest", filename);
+}
+
+// classes non vides (offsets strictement croissants de 0 à n), chaque
+// sommet de 1..n dans exactement une classe
+static void check_chain_partition(int n, int64_t nclasses, const int64_t *offsets,
+                                  const int *members, const char *filename) {
+    for (int64_t c = 0; c < nclasses; ++c)
+        if (offsets[c] >= offsets[c + 1]) chain_reject("classes", filename);
+
+    char *seen = (char*)calloc((size_t)n + 1, 1);
+    if (!seen) {
+        perror("malloc partition check");
+        exit(EXIT_FAILURE);
+    }
+    for (int64_t k = 0; k < offsets[nclasses]; ++k) {
+        int v = members[k];
+        if (v < 1 || v > n || seen[v]) {
+            free(seen);
+            chain_reject("members", filename);
+        }
+        seen[v] = 1;
+    }
+    free(seen);
+}
+
+CsrGraph readChainBinary(const char *filename, TarjanPartition *P) {
+    MappedFile *F = (MappedFile*)malloc(sizeof(MappedFile));
+    if (!F) {
+        perror("malloc mapped file");
+        exit(EXIT_FAILURE);
+    }
+    *F = mapped_file_open(filename);
+
+    ChainHeader H;
+    if (F->size < sizeof(H)) {
+        fprintf(stderr, "Not a chain file: %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(&H, F->data, sizeof(H));
+    if (memcmp(H.magic, CHAIN_MAGIC, sizeof(H.magic)) != 0) {
+        fprintf(stderr, "Not a chain file: %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    if (H.version != CHAIN_VERSION || H.endian != CHAIN_ENDIAN
+        || H.prob_size != sizeof(prob_t) || H.n < 0 || H.n > INT32_MAX || H.m < 0) {
+        fprintf(stderr, "Unsupported chain file (version %u): %s\n", H.version, filename);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t off = sizeof(H);
+    size_t o_row  = chain_section(F, &off, ((size_t)H.n + 2) * sizeof(int64_t), "row");
+    size_t o_dest = chain_section(F, &off, (size_t)H.m * sizeof(int), "dest");
+    size_t o_prob = chain_section(F, &off, (size_t)H.m * sizeof(prob_t), "prob");
+
+    CsrGraph G;
+    G.n = (int)H.n;
+    G.m = H.m;
+    G.row  = (int64_t*)(F->data + o_row);
+    G.dest = (int*)(F->data + o_dest);
+    G.prob = (prob_t*)(F->data + o_prob);
+    G.storage = F;
+    G.release = release_mapped_chain;
+    check_chain_graph(&G, filename);
+
+    if (P) {
+        *P = partition_create();
+        if (H.flags & CHAIN_HAS_PARTITION) {
+            // classes non vides en pratique : jamais plus que de sommets
+            if (H.nclasses < 0 || H.nclasses > H.n) chain_reject("classes", filename);
+            size_t o_off = chain_section(F, &off, ((size_t)H.nclasses + 1) * sizeof(int64_t), "classes");
+            const int64_t *offsets = (const int64_t*)(F->data + o_off);
+            // n membres distincts de 1..n : chaque sommet a exactement une classe
+            if (offsets[0] != 0 || offsets[H.nclasses] != H.n)
+                chain_reject("classes", filename);
+            size_t o_mem = chain_section(F, &off, (size_t)offsets[H.nclasses] * sizeof(int), "members");
+            const int *members = (const int*)(F->data + o_mem);
+            check_chain_partition(G.n, H.nclasses, offsets, members, filename);
+
+            *P = partition_create_pooled((int)H.n);
+            for (int64_t c = 0; c < H.nclasses; ++c) {
+                char name[CLASS_NAME_SIZE];
+                snprintf(name, sizeof(name), "C%d", (int)c + 1);
+                TarjanClass C = partition_new_class(P, name, (int)(offsets[c + 1] - offsets[c]));
+                for (int64_t k = offsets[c]; k < offsets[c + 1]; ++k)
+                    class_add_member(&C, members[k]);
+                partition_add_class(P, C);
+            }
+            partition_finalize(P, G.n);
+        }
+    }
+
+    return G;
+}
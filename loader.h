@@ -0,0 +1,62 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+#include "graph.h"
+#include "tarjan.h"
+
+// Fichier projeté en mémoire (copie privée : les écritures éventuelles ne
+// touchent que la mémoire du processus, jamais le fichier)
+typedef struct {
+    const char *data;      // contenu du fichier
+    size_t      size;      // taille en octets
+    int         mapped;    // 1 si mmap, 0 si copie en mémoire (repli)
+} MappedFile;
+
+// Projette le fichier en mémoire (mmap, ou lecture complète en repli)
+MappedFile mapped_file_open(const char *filename);
+void       mapped_file_close(MappedFile *F);
+
+// Lit un fichier d’arcs au format du sujet sans fscanf ("-" : entrée
+// standard, lue en flux). Renvoie le nombre de sommets et remplit E (arcs dans l’ordre du fichier).
+// nthreads > 1 : le fichier est découpé sur des fins de ligne et chaque
+// thread remplit son propre tableau d’arcs, fusionnés ensuite dans l’ordre.
+int load_edges(const char *filename, int nthreads, EdgeList *E);
+
+// Lecture rapide directement en CSR (fusion des tableaux de chaque thread)
+CsrGraph readGraphFast(const char *filename, int nthreads);
+
+// ---------- Lecture en flux (tube, stdin, socket...) ----------
+// Le texte est lu par blocs de LOADER_STREAM_CHUNK octets et analysé au fil
+// de l’eau : la mémoire occupée est celle des arcs, plus un bloc de texte.
+// Même format et même arrêt au premier triplet invalide que load_edges.
+#ifndef LOADER_STREAM_CHUNK
+#define LOADER_STREAM_CHUNK (1 << 20)
+#endif
+
+int      load_edges_stream(FILE *f, EdgeList *E);
+int      load_edges_fd(int fd, EdgeList *E);   // fd 0 : entrée standard
+CsrGraph readGraphStream(FILE *f);
+CsrGraph readGraphFd(int fd);
+
+// ---------- Format binaire d’une chaîne (version 1) ----------
+// En-tête de 64 octets, puis sections alignées sur 8 octets :
+//   row[n+2] (int64), dest[m] (int32), prob[m] (prob_t),
+//   et si la partition est présente : offsets[k+1] (int64), membres[n] (int32)
+#define CHAIN_MAGIC   "MKVCHAIN"
+#define CHAIN_VERSION 1
+
+// Écrit le graphe (et la partition si P != NULL) dans un fichier binaire
+void saveChainBinary(const char *filename, const CsrGraph *G, const TarjanPartition *P);
+
+// Projette un fichier binaire : les tableaux du graphe pointent dans le
+// fichier projeté (aucune copie), libéré par csr_free ; ils restent
+// modifiables (pages copiées à la première écriture). Un fichier écrit
+// avec une autre précision (taille de prob_t différente) est refusé, de
+// même qu’un fichier dont les sections sont incohérentes (row non
+// croissant, destination ou membre hors de 1..n, classes qui ne couvrent
+// pas chaque sommet exactement une fois).
+// Si P != NULL, il reçoit la partition enregistrée (vide si absente).
+CsrGraph readChainBinary(const char *filename, TarjanPartition *P);
+
+#endif // LOADER_H
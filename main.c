@@ -1,10 +1,55 @@
 #include <stdio.h>
+#include <string.h>
 #include "graph.h"
 #include "tarjan.h"
 #include "caracteristiques.h"
 #include "matrix.h"
+#include "stationary.h"
+#include "batch.h"
+#include "absorption.h"
+
+/*
+   Mode lot : main [-j threads] [-o dossier] fichier|dossier ...
+   Chaque chaîne est analysée sur un thread du pool ; ses résultats vont
+   dans <dossier>/<fichier>.result.txt, extension d’entrée comprise
+   (exemple3.txt -> exemple3.txt.result.txt), dossier courant par défaut.
+   Si deux entrées ont le même nom, tous les fichiers de résultats sont
+   préfixés par le rang de l’entrée : <rang>-<fichier>.result.txt.
+*/
+static int run_batch(int argc, char **argv) {
+    BatchOptions opt = batch_default_options();
+    char **files = NULL;
+    int count = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) opt.nthreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) opt.out_dir = argv[++i];
+        else batch_collect(argv[i], &files, &count);
+    }
+    if (count == 0) {
+        fprintf(stderr, "Usage : %s [-j threads] [-o dossier] fichier|dossier ...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
 
-int main(void) {
+    ChainResult *results = (ChainResult*)malloc(count * sizeof(ChainResult));
+    if (!results) {
+        perror("malloc results");
+        exit(EXIT_FAILURE);
+    }
+    double elapsed = batch_run(files, count, &opt, results);
+    batch_print_summary(stdout, results, count);
+
+    int failed = 0;
+    for (int i = 0; i < count; ++i) failed += !results[i].ok;
+    printf("%d chaines (%d en erreur) en %.3f s\n", count, failed, elapsed);
+
+    free(results);
+    batch_free_files(files, count);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) return run_batch(argc, argv);
 
     const char *path = "../data/exemple3.txt";
 
@@ -21,16 +66,21 @@ int main(void) {
        ============================== */
     printf("*** Partie 1 : Analyse du graphe ***\n");
 
-    AdjList G = readGraph(path);
+    // lecture validée au passage (bornes, signes, doublons fusionnés, sommes)
+    LoadReport R;
+    CsrGraph C = readGraphChecked(path, 1, &R);   // arcs contigus pour les calculs
+    AdjList G = adj_from_csr(&C, 1);
 
     printf("\n1) Liste d adjacence :\n");
     adj_print(&G);
 
     printf("\n2) Verification Markov :\n");
-    if (adj_is_markov(&G))
+    if (R.is_markov) {
         printf("Le graphe est un graphe de Markov.\n");
-    else
+    } else {
+        load_report_print(&R);
         printf("Le graphe n est pas un graphe de Markov.\n");
+    }
 
     printf("\n3) Export du graphe au format Mermaid...\n");
     adj_to_mermaid(&G, "graph_mermaid.txt");
@@ -41,21 +91,22 @@ int main(void) {
        ================================================ */
     printf("\n*** Partie 2 : Composantes fortement connexes ***\n");
 
-    TarjanPartition P = tarjan_run(&G);
+    TarjanPartition P = tarjan_run_csr(&C);
     partition_print(&P);
 
     printf("\n4) Diagramme de Hasse :\n");
 
     t_link_array L;
-    build_class_links(&G, &P, &L);
+    build_class_links_csr(&C, &P, &L);
     print_class_links(&L);
 
-    removeTransitiveLinks(&L);
+    transitiveReduction(&L, P.size);
     hasse_to_mermaid(&P, &L, "hasse_mermaid.txt");
     printf("Fichier 'hasse_mermaid.txt' genere.\n");
 
     printf("\n5) Caracteristiques du graphe :\n");
-    printGraphCharacteristics(&P, &L);
+    Classification K = classify_classes(&C, &P);   // O(V + E), sans Hasse
+    printClassification(&P, &K);
 
     /* ====================================
        PARTIE 3 : Matrices de transition
@@ -63,75 +114,99 @@ int main(void) {
     printf("\n*** Partie 3 : Matrices du graphe ***\n");
 
     /* Matrice M */
-    float **M = matrix_from_graph(&G);
+    Matrix M = matrix_from_csr(&C);
     printf("\nMatrice M :\n");
-    matrix_print(M, G.n);
-
-    /* M^3 */
-    float **M2 = matrix_create(G.n);
-    float **M3 = matrix_create(G.n);
+    matrix_print(&M);
 
-    matrix_mult(M, M, M2, G.n);
-    matrix_mult(M2, M, M3, G.n);
+    /* M^3 et M^7 par exponentiation rapide */
+    Matrix M3 = matrix_pow(&M, 3);
 
     printf("M^3 :\n");
-    matrix_print(M3, G.n);
+    matrix_print(&M3);
 
-    /* M^7 */
-    float **tmp = matrix_create(G.n);
-    matrix_copy(tmp, M3, G.n);
-
-    for (int i = 4; i <= 7; i++) {
-        float **next = matrix_create(G.n);
-        matrix_mult(tmp, M, next, G.n);
-        matrix_free(tmp, G.n);
-        tmp = next;
-    }
+    Matrix M7 = matrix_pow(&M, 7);
 
     printf("M^7 :\n");
-    matrix_print(tmp, G.n);
+    matrix_print(&M7);
 
     /* Convergence */
     printf("\n*** Test de convergence ***\n");
 
-    float **A = matrix_create(G.n);
-    float **B = matrix_create(G.n);
-    matrix_copy(A, M, G.n);
-
-    int n_iter = 0;
-
-    while (1) {
-        matrix_mult(A, M, B, G.n);
-        float d = matrix_diff(A, B, G.n);
+    // une classe persistante périodique empêche M^n de converger : on le
+    // détecte avant d'itérer et on passe à la moyenne de Cesàro
+    int period = classification_period(&K);
+    if (period > 1)
+        printf("Classes periodiques (periode %d) : limite au sens de Cesaro.\n", period);
+
+    // écart L1 mesuré à chaque produit, dans le noyau de multiplication
+    ConvergenceOptions copt = convergence_default_options();
+    MatrixLimitReport conv;
+    Matrix B = matrix_limit(&M, period, &copt, &conv);
+
+    if (period == 0) {
+        // ppcm des périodes > INT_MAX : matrix_limit n'a rien itéré
+        printf("Periode trop grande : moyenne de Cesaro non calculee.\n");
+    } else {
+        if (conv.converged)
+            printf("Convergence atteinte apres %d iterations (diff = %.4f)\n", conv.iterations, conv.diff);
+        else
+            printf("Pas de convergence trouvee.\n");
 
-        if (d < 0.01f) {
-            printf("Convergence atteinte apres %d iterations (diff = %.4f)\n", n_iter, d);
-            break;
-        }
+        printf("\nM^n (limite) :\n");
+        matrix_print(&B);
+    }
 
-        matrix_copy(A, B, G.n);
-        n_iter++;
+    /* Distribution stationnaire de chaque classe fermee (iteration creuse) */
+    printf("\n*** Distributions stationnaires (iteration creuse) ***\n");
 
-        if (n_iter > 1000) {
-            printf("Pas de convergence trouvee.\n");
-            break;
+    StationaryOptions opt = stationary_default_options();
+    prob_t *pi = malloc((G.n + 1) * sizeof(prob_t));
+    int *pos = malloc((G.n + 1) * sizeof(int));
+    if (!pi || !pos) {
+        perror("malloc stationary");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v <= G.n; v++) pos[v] = -1;
+    for (int c = 0; c < P.size; c++) {
+        StationaryReport rep = stationary_class(&C, &P, c, &opt, pos, pi);
+        if (!rep.closed) continue;   // classe transitoire
+
+        printf("Classe %s (%d iterations%s) :", P.classes[c].name, rep.iterations,
+               rep.converged ? "" : ", non convergee");
+        for (int k = 0; k < P.classes[c].size; k++) {
+            int v = P.classes[c].members[k];
+            printf(" pi(%d)=%.4f", v, pi[v]);
         }
+        printf("\n");
     }
 
-    printf("\nM^n (limite) :\n");
-    matrix_print(B, G.n);
+    /* Distribution limite globale depuis une loi initiale uniforme */
+    LimitReport lim = stationary_limit(&C, &P, NULL, &opt, 0, pi);
+    printf("\nDistribution limite (depart uniforme, %d classes fermees) :\n", lim.closed_classes);
+    for (int v = 1; v <= G.n; v++)
+        printf("%.4f ", pi[v]);
+    printf("\n");
+    free(pos);
+    free(pi);
+
+    /* Absorption : systemes de la matrice fondamentale, sans puissance de M */
+    printf("\n*** Absorption dans les classes persistantes ***\n");
+    Absorption abs = absorption_dense(&M, &P, &K);
+    absorption_print(&P, &abs);
+    absorption_free(&abs);
 
     /* Liberation memoire */
     free(L.data);
+    classification_free(&K);
     partition_free(&P);
+    csr_free(&C);
+    load_report_free(&R);
     adj_free(&G);
 
-    matrix_free(M, G.n);
-    matrix_free(M2, G.n);
-    matrix_free(M3, G.n);
-    matrix_free(tmp, G.n);
-    matrix_free(A, G.n);
-    matrix_free(B, G.n);
+    matrix_free(&M);
+    matrix_free(&M3);
+    matrix_free(&M7);
+    matrix_free(&B);
 
     printf("*******************************************************\n");
     printf("*******************************************************\n");
@@ -1,22 +1,51 @@
 #include "matrix.h"
+#include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATRIX_X86 1
+#include <immintrin.h>
+#endif
 
+// Lignes de B parcourues par bloc : une bande de BLOCK_K × MATRIX_STRIP
+// éléments (64 Ko en float, 128 Ko en double) reste en cache pendant
+// qu'on balaie toutes les lignes de A
+#define BLOCK_K 256
 
-float **matrix_create(int n) {
-    float **M = malloc(n * sizeof(float *));
-    if (!M) {
+
+// ===============================
+// Allocation alignée
+// ===============================
+
+static prob_t *aligned_zeros(size_t count) {
+    size_t bytes = (count > 0 ? count : 1) * sizeof(prob_t);
+    void *p = NULL;
+#ifdef _WIN32
+    p = _aligned_malloc(bytes, 64);
+#else
+    if (posix_memalign(&p, 64, bytes) != 0) p = NULL;
+#endif
+    if (!p) {
         perror("malloc matrix");
         exit(EXIT_FAILURE);
     }
+    memset(p, 0, bytes);
+    return (prob_t*)p;
+}
+
+static void aligned_free(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
 
-    for (int i = 0; i < n; i++) {
-        M[i] = calloc(n, sizeof(float)); // initialise à 0
-        if (!M[i]) {
-            perror("calloc matrix row");
-            exit(EXIT_FAILURE);
-        }
-    }
 
+Matrix matrix_create(int n) {
+    Matrix M;
+    M.n = n;
+    M.ld = ((n + MATRIX_STRIP - 1) / MATRIX_STRIP) * MATRIX_STRIP;
+    M.data = aligned_zeros((size_t)n * M.ld);   // initialise à 0
     return M;
 }
 
@@ -24,23 +53,20 @@ float **matrix_create(int n) {
 // Libération mémoire
 // ===============================
 
-void matrix_free(float **M, int n) {
-    if (!M) return;
-
-    for (int i = 0; i < n; i++)
-        free(M[i]);
-
-    free(M);
+void matrix_free(Matrix *M) {
+    if (!M || !M->data) return;
+    aligned_free(M->data);
+    M->data = NULL;
+    M->n = 0;
+    M->ld = 0;
 }
 
 // ===============================
 // Copier une matrice
 // ===============================
 
-void matrix_copy(float **dest, float **src, int n) {
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            dest[i][j] = src[i][j];
+void matrix_copy(Matrix *dest, const Matrix *src) {
+    memcpy(dest->data, src->data, (size_t)src->n * src->ld * sizeof(prob_t));
 }
 
 // ===============================
@@ -48,14 +74,27 @@ void matrix_copy(float **dest, float **src, int n) {
 // en matrice n×n
 // ===============================
 
-float **matrix_from_graph(const AdjList *G) {
+Matrix matrix_from_graph(const AdjList *G) {
     int n = G->n;
-    float **M = matrix_create(n);
+    Matrix M = matrix_create(n);
 
     for (int u = 1; u <= n; u++) {
         for (Cell *c = G->arr[u].head; c != NULL; c = c->next) {
             int v = c->dest;
-            M[u - 1][v - 1] = c->prob;   // indices 0-based
+            MAT(&M, u - 1, v - 1) = c->prob;   // indices 0-based
+        }
+    }
+
+    return M;
+}
+
+Matrix matrix_from_csr(const CsrGraph *G) {
+    int n = G->n;
+    Matrix M = matrix_create(n);
+
+    for (int u = 1; u <= n; u++) {
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; k++) {
+            MAT(&M, u - 1, G->dest[k] - 1) = G->prob[k];   // indices 0-based
         }
     }
 
@@ -67,20 +106,482 @@ float **matrix_from_graph(const AdjList *G) {
 // R = A × B
 // ===============================
 
-void matrix_mult(float **A, float **B, float **R, int n) {
+/*
+   Tous les noyaux suivent le même schéma :
+   pour chaque bloc de lignes k de B et chaque bande de MATRIX_STRIP colonnes,
+   la bande R[i][jj..jj+STRIP) reste dans des registres pendant qu'on accumule
+   A[i][k] * B[k][jj..] sur tout le bloc. Les A[i][k] nuls (la plupart, pour
+   une matrice de transition) sont sautés.
+   Une version SIMD par précision : float (8 ou 16 par registre), double
+   (4 ou 8), et mixed qui charge des float et les convertit en double.
+   Si ref n'est pas NULL, chaque bande de R est comparée à ref juste après
+   son dernier bloc de k, tant qu'elle est encore en cache : row_l1[i] et
+   row_max[i] reçoivent la somme et le max des |R - ref| de la ligne i.
+*/
+
+// Écart d'une bande de R (len valeurs, multiple de 8) avec la même bande de
+// ref : huit sommes et huit max indépendants, que le compilateur vectorise
+static inline void strip_diff(const prob_t *r, const prob_t *ref, int len, acc_t *l1, acc_t *mx) {
+    acc_t s[8] = { 0 }, m[8] = { 0 };
+    for (int j = 0; j < len; j += 8)
+        for (int q = 0; q < 8; q++) {
+            acc_t d = fabs((acc_t)r[j + q] - (acc_t)ref[j + q]);
+            s[q] += d;
+            m[q] = d > m[q] ? d : m[q];
+        }
+    acc_t sum = 0, mmax = *mx;
+    for (int q = 0; q < 8; q++) {
+        sum += s[q];
+        if (m[q] > mmax) mmax = m[q];
+    }
+    *l1 += sum;
+    *mx = mmax;
+}
+
+static void mult_scalar(const Matrix *A, const Matrix *B, Matrix *R,
+                        const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                acc_t acc[MATRIX_STRIP];
+                prob_t *r = &MAT(R, i, jj);
+                for (int j = 0; j < MATRIX_STRIP; j++) acc[j] = r[j];
+
+                for (int k = kk; k < kend; k++) {
+                    acc_t a = MAT(A, i, k);
+                    if (a == 0) continue;
+                    const prob_t *b = &MAT(B, k, jj);
+                    for (int j = 0; j < MATRIX_STRIP; j++)
+                        acc[j] += a * b[j];
+                }
+                for (int j = 0; j < MATRIX_STRIP; j++) r[j] = (prob_t)acc[j];
+                if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj), MATRIX_STRIP, row_l1 + i, row_max + i);
+            }
+        }
+    }
+}
+
+#if defined(MATRIX_X86) && MARKOV_PRECISION == MARKOV_FLOAT
+__attribute__((target("avx2,fma")))
+static void mult_avx2(const Matrix *A, const Matrix *B, Matrix *R,
+                      const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                float *r = &MAT(R, i, jj);
+                __m256 c0 = _mm256_load_ps(r),      c1 = _mm256_load_ps(r + 8);
+                __m256 c2 = _mm256_load_ps(r + 16), c3 = _mm256_load_ps(r + 24);
+                __m256 c4 = _mm256_load_ps(r + 32), c5 = _mm256_load_ps(r + 40);
+                __m256 c6 = _mm256_load_ps(r + 48), c7 = _mm256_load_ps(r + 56);
+
+                for (int k = kk; k < kend; k++) {
+                    float a = MAT(A, i, k);
+                    if (a == 0.0f) continue;
+                    __m256 va = _mm256_set1_ps(a);
+                    const float *b = &MAT(B, k, jj);
+                    c0 = _mm256_fmadd_ps(va, _mm256_load_ps(b),      c0);
+                    c1 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 8),  c1);
+                    c2 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 16), c2);
+                    c3 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 24), c3);
+                    c4 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 32), c4);
+                    c5 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 40), c5);
+                    c6 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 48), c6);
+                    c7 = _mm256_fmadd_ps(va, _mm256_load_ps(b + 56), c7);
+                }
+
+                _mm256_store_ps(r, c0);      _mm256_store_ps(r + 8, c1);
+                _mm256_store_ps(r + 16, c2); _mm256_store_ps(r + 24, c3);
+                _mm256_store_ps(r + 32, c4); _mm256_store_ps(r + 40, c5);
+                _mm256_store_ps(r + 48, c6); _mm256_store_ps(r + 56, c7);
+                if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj), MATRIX_STRIP, row_l1 + i, row_max + i);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void mult_avx512(const Matrix *A, const Matrix *B, Matrix *R,
+                        const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                float *r = &MAT(R, i, jj);
+                __m512 c0 = _mm512_load_ps(r),      c1 = _mm512_load_ps(r + 16);
+                __m512 c2 = _mm512_load_ps(r + 32), c3 = _mm512_load_ps(r + 48);
+
+                for (int k = kk; k < kend; k++) {
+                    float a = MAT(A, i, k);
+                    if (a == 0.0f) continue;
+                    __m512 va = _mm512_set1_ps(a);
+                    const float *b = &MAT(B, k, jj);
+                    c0 = _mm512_fmadd_ps(va, _mm512_load_ps(b),      c0);
+                    c1 = _mm512_fmadd_ps(va, _mm512_load_ps(b + 16), c1);
+                    c2 = _mm512_fmadd_ps(va, _mm512_load_ps(b + 32), c2);
+                    c3 = _mm512_fmadd_ps(va, _mm512_load_ps(b + 48), c3);
+                }
+
+                _mm512_store_ps(r, c0);      _mm512_store_ps(r + 16, c1);
+                _mm512_store_ps(r + 32, c2); _mm512_store_ps(r + 48, c3);
+                if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj), MATRIX_STRIP, row_l1 + i, row_max + i);
+            }
+        }
+    }
+}
+
+#elif defined(MATRIX_X86) && MARKOV_PRECISION == MARKOV_DOUBLE
+// AVX2 : 16 registres seulement, la bande de 64 double est faite en deux moitiés
+__attribute__((target("avx2,fma")))
+static void mult_avx2(const Matrix *A, const Matrix *B, Matrix *R,
+                      const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                for (int h = 0; h < MATRIX_STRIP; h += 32) {
+                    double *r = &MAT(R, i, jj + h);
+                    __m256d c[8];
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++) c[q] = _mm256_load_pd(r + 4 * q);
+
+                    for (int k = kk; k < kend; k++) {
+                        double a = MAT(A, i, k);
+                        if (a == 0.0) continue;
+                        __m256d va = _mm256_set1_pd(a);
+                        const double *b = &MAT(B, k, jj + h);
+#pragma GCC unroll 8
+                        for (int q = 0; q < 8; q++)
+                            c[q] = _mm256_fmadd_pd(va, _mm256_load_pd(b + 4 * q), c[q]);
+                    }
+
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++) _mm256_store_pd(r + 4 * q, c[q]);
+                    if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj + h), 32, row_l1 + i, row_max + i);
+                }
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void mult_avx512(const Matrix *A, const Matrix *B, Matrix *R,
+                        const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                double *r = &MAT(R, i, jj);
+                __m512d c[8];
+#pragma GCC unroll 8
+                for (int q = 0; q < 8; q++) c[q] = _mm512_load_pd(r + 8 * q);
+
+                for (int k = kk; k < kend; k++) {
+                    double a = MAT(A, i, k);
+                    if (a == 0.0) continue;
+                    __m512d va = _mm512_set1_pd(a);
+                    const double *b = &MAT(B, k, jj);
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++)
+                        c[q] = _mm512_fmadd_pd(va, _mm512_load_pd(b + 8 * q), c[q]);
+                }
+
+#pragma GCC unroll 8
+                for (int q = 0; q < 8; q++) _mm512_store_pd(r + 8 * q, c[q]);
+                if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj), MATRIX_STRIP, row_l1 + i, row_max + i);
+            }
+        }
+    }
+}
+
+#elif defined(MATRIX_X86) && MARKOV_PRECISION == MARKOV_MIXED
+// Stockage float, accumulateurs double : chaque chargement de B est élargi
+// (cvtps_pd) et R n'est réarrondi en float qu'une fois par bloc de k
+__attribute__((target("avx2,fma")))
+static void mult_avx2(const Matrix *A, const Matrix *B, Matrix *R,
+                      const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                for (int h = 0; h < MATRIX_STRIP; h += 32) {
+                    float *r = &MAT(R, i, jj + h);
+                    __m256d c[8];
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++) c[q] = _mm256_cvtps_pd(_mm_load_ps(r + 4 * q));
+
+                    for (int k = kk; k < kend; k++) {
+                        float a = MAT(A, i, k);
+                        if (a == 0.0f) continue;
+                        __m256d va = _mm256_set1_pd(a);
+                        const float *b = &MAT(B, k, jj + h);
+#pragma GCC unroll 8
+                        for (int q = 0; q < 8; q++)
+                            c[q] = _mm256_fmadd_pd(va, _mm256_cvtps_pd(_mm_load_ps(b + 4 * q)), c[q]);
+                    }
+
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++) _mm_store_ps(r + 4 * q, _mm256_cvtpd_ps(c[q]));
+                    if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj + h), 32, row_l1 + i, row_max + i);
+                }
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void mult_avx512(const Matrix *A, const Matrix *B, Matrix *R,
+                        const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    int n = A->n, ld = A->ld;
+
+    for (int kk = 0; kk < n; kk += BLOCK_K) {
+        int kend = (kk + BLOCK_K < n) ? kk + BLOCK_K : n;
+        for (int jj = 0; jj < ld; jj += MATRIX_STRIP) {
+            for (int i = 0; i < n; i++) {
+                float *r = &MAT(R, i, jj);
+                __m512d c[8];
+#pragma GCC unroll 8
+                for (int q = 0; q < 8; q++) c[q] = _mm512_cvtps_pd(_mm256_load_ps(r + 8 * q));
+
+                for (int k = kk; k < kend; k++) {
+                    float a = MAT(A, i, k);
+                    if (a == 0.0f) continue;
+                    __m512d va = _mm512_set1_pd(a);
+                    const float *b = &MAT(B, k, jj);
+#pragma GCC unroll 8
+                    for (int q = 0; q < 8; q++)
+                        c[q] = _mm512_fmadd_pd(va, _mm512_cvtps_pd(_mm256_load_ps(b + 8 * q)), c[q]);
+                }
+
+#pragma GCC unroll 8
+                for (int q = 0; q < 8; q++) _mm256_store_ps(r + 8 * q, _mm512_cvtpd_ps(c[q]));
+                if (ref && kend == n) strip_diff(r, &MAT(ref, i, jj), MATRIX_STRIP, row_l1 + i, row_max + i);
+            }
+        }
+    }
+}
+#endif
+
+typedef void (*MultKernel)(const Matrix *, const Matrix *, Matrix *,
+                           const Matrix *, acc_t *, acc_t *);
+
+// Choix du noyau selon le processeur (à l'exécution)
+static MultKernel select_kernel(const char **name) {
+#ifdef MATRIX_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        if (name) *name = "avx512";
+        return mult_avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        if (name) *name = "avx2";
+        return mult_avx2;
+    }
+#endif
+    if (name) *name = "scalar";
+    return mult_scalar;
+}
+
+const char *matrix_kernel_name(void) {
+    const char *name;
+    select_kernel(&name);
+    return name;
+}
+
+// R ne doit pas être A ou B
+void matrix_mult(const Matrix *A, const Matrix *B, Matrix *R) {
     // initialiser R à 0
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            R[i][j] = 0.0f;
+    memset(R->data, 0, (size_t)R->n * R->ld * sizeof(prob_t));
 
     // multiplication
-    for (int i = 0; i < n; i++) {
-        for (int k = 0; k < n; k++) {
-            for (int j = 0; j < n; j++) {
-                R[i][j] += A[i][k] * B[k][j];
+    select_kernel(NULL)(A, B, R, NULL, NULL, NULL);
+}
+
+void matrix_mult_diff(const Matrix *A, const Matrix *B, Matrix *R,
+                      const Matrix *ref, acc_t *row_l1, acc_t *row_max) {
+    memset(R->data, 0, (size_t)R->n * R->ld * sizeof(prob_t));
+    for (int i = 0; i < R->n; i++) row_l1[i] = row_max[i] = 0;
+    select_kernel(NULL)(A, B, R, ref, row_l1, row_max);
+}
+
+// ===============================
+// Puissance par exponentiation rapide
+// M^k = produit des M^(2^i) pour les bits i de k
+// ===============================
+
+static void swap_matrix(Matrix **a, Matrix **b) {
+    Matrix *t = *a;
+    *a = *b;
+    *b = t;
+}
+
+Matrix matrix_pow(const Matrix *M, int k) {
+    int n = M->n;
+    Matrix bufs[3] = { matrix_create(n), matrix_create(n), matrix_create(n) };
+    Matrix *result = &bufs[0];   // produit partiel
+    Matrix *base = &bufs[1];     // M^(2^i)
+    Matrix *tmp = &bufs[2];      // destination de la multiplication en cours
+    int has_result = 0;          // tant que 0, result vaut l'identité
+
+    matrix_copy(base, M);
+    while (k > 0) {
+        if (k & 1) {
+            if (has_result) {
+                matrix_mult(result, base, tmp);
+                swap_matrix(&result, &tmp);
+            } else {
+                matrix_copy(result, base);   // I × base : pas de produit
+                has_result = 1;
             }
         }
+        k >>= 1;
+        if (k > 0) {
+            matrix_mult(base, base, tmp);
+            swap_matrix(&base, &tmp);
+        }
     }
+
+    if (!has_result) {
+        // M^0 = identité
+        for (int i = 0; i < n; i++) MAT(result, i, i) = 1;
+    }
+
+    // on rend le tampon qui contient le résultat, les deux autres sont libérés
+    Matrix out = *result;
+    for (int i = 0; i < 3; i++)
+        if (bufs[i].data != out.data) matrix_free(&bufs[i]);
+    return out;
+}
+
+// ===============================
+// Pilote de convergence
+// ===============================
+
+ConvergenceOptions convergence_default_options(void) {
+    ConvergenceOptions opt;
+    opt.norm = CONV_L1;
+    opt.tol = 0.01f;
+    opt.max_iter = 1000;
+    opt.check_every = 1;
+    return opt;
+}
+
+Matrix matrix_converge(const Matrix *X0, const Matrix *Q, const ConvergenceOptions *opt,
+                       ConvergenceReport *rep) {
+    ConvergenceOptions def = convergence_default_options();
+    if (!opt) opt = &def;
+    int every = opt->check_every > 0 ? opt->check_every : 1;
+    int n = X0->n;
+    ConvergenceReport R = { 0, 0, 0, 0, 0 };
+
+    Matrix bufs[2] = { matrix_create(n), matrix_create(n) };
+    Matrix *a = &bufs[0];   // itéré courant
+    Matrix *b = &bufs[1];   // itéré suivant
+    acc_t *row_l1 = (acc_t*)malloc(((size_t)n + 1) * sizeof(acc_t));
+    acc_t *row_max = (acc_t*)malloc(((size_t)n + 1) * sizeof(acc_t));
+    if (!row_l1 || !row_max) {
+        perror("malloc convergence rows");
+        exit(EXIT_FAILURE);
+    }
+    matrix_copy(a, X0);
+
+    int products = 0;
+    while (1) {
+        products++;
+        // le dernier produit autorisé est toujours mesuré
+        int check = (products % every == 0) || products > opt->max_iter;
+        if (check) matrix_mult_diff(a, Q, b, a, row_l1, row_max);
+        else matrix_mult(a, Q, b);
+        swap_matrix(&a, &b);
+
+        if (check) {
+            const acc_t *row = (opt->norm == CONV_LINF) ? row_max : row_l1;
+            acc_t d = 0;
+            R.checks++;
+            R.worst_row = 0;
+            for (int i = 0; i < n; i++) {
+                if (row[i] > row[R.worst_row]) R.worst_row = i;
+                if (opt->norm == CONV_L1) d += row[i];
+                else if (row[i] > d) d = row[i];
+            }
+            R.diff = d;
+            if (d < opt->tol) {
+                R.converged = 1;
+                break;
+            }
+        }
+        if (products > opt->max_iter) break;
+    }
+    R.iterations = products - 1;
+
+    // on rend le tampon du dernier itéré
+    Matrix out = *a;
+    matrix_free(b);
+    free(row_l1);
+    free(row_max);
+    if (rep) *rep = R;
+    return out;
+}
+
+// ===============================
+// Limite de M^n (Cesàro si périodique)
+// ===============================
+
+Matrix matrix_limit(const Matrix *M, int period, const ConvergenceOptions *opt, MatrixLimitReport *rep) {
+    int n = M->n;
+    MatrixLimitReport R = { period, 0, 0, 0 };
+
+    if (period <= 0) {
+        Matrix out = matrix_create(n);
+        matrix_copy(&out, M);
+        if (rep) *rep = R;
+        return out;
+    }
+
+    Matrix Q = period > 1 ? matrix_pow(M, period) : *M;
+    ConvergenceReport C;
+    Matrix out = matrix_converge(&Q, &Q, opt, &C);   // M^(k * period)
+    R.iterations = C.iterations;
+    R.converged = C.converged;
+    R.diff = C.diff;
+
+    if (period > 1) {
+        // moyenne sur les period phases : S = (A + A M + ...) / period
+        Matrix S = matrix_create(n);
+        Matrix bufs[2] = { matrix_create(n), matrix_create(n) };
+        Matrix *a = &out;
+        Matrix *b = &bufs[0];
+        matrix_copy(&S, a);
+        for (int r = 1; r < period; r++) {
+            matrix_mult(a, M, b);
+            a = b;
+            b = (b == &bufs[0]) ? &bufs[1] : &bufs[0];
+            for (size_t i = 0, total = (size_t)n * S.ld; i < total; i++)
+                S.data[i] += a->data[i];
+        }
+        for (size_t i = 0, total = (size_t)n * S.ld; i < total; i++)
+            S.data[i] = (prob_t)(S.data[i] / period);
+        matrix_free(&bufs[0]);
+        matrix_free(&bufs[1]);
+        matrix_free(&Q);
+        matrix_free(&out);
+        out = S;
+    }
+
+    if (rep) *rep = R;
+    return out;
 }
 
 // ===============================
@@ -88,12 +589,14 @@ void matrix_mult(float **A, float **B, float **R, int n) {
 // Somme des |M_ij - N_ij|
 // ===============================
 
-float matrix_diff(float **A, float **B, int n) {
-    float d = 0.0f;
+acc_t matrix_diff(const Matrix *A, const Matrix *B) {
+    // les colonnes de bourrage sont nulles des deux côtés :
+    // on parcourt le bloc entier d'un seul tenant
+    size_t total = (size_t)A->n * A->ld;
+    acc_t d = 0;
 
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            d += fabsf(A[i][j] - B[i][j]);
+    for (size_t i = 0; i < total; i++)
+        d += fabs((acc_t)A->data[i] - (acc_t)B->data[i]);
 
     return d;
 }
@@ -102,10 +605,10 @@ float matrix_diff(float **A, float **B, int n) {
 // Affichage d'une matrice
 // ===============================
 
-void matrix_print(float **M, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%.4f ", M[i][j]);
+void matrix_print(const Matrix *M) {
+    for (int i = 0; i < M->n; i++) {
+        for (int j = 0; j < M->n; j++) {
+            printf("%.4f ", MAT(M, i, j));
         }
         printf("\n");
     }
@@ -114,29 +617,33 @@ void matrix_print(float **M, int n) {
 // =============================================================
 // Sous-matrice correspondant à une composante fortement connexe
 // =============================================================
-float **subMatrix(float **matrix, const TarjanPartition *part, int compo_index, int *out_n)
+Matrix subMatrix(const Matrix *matrix, const TarjanPartition *part, int compo_index)
 {
     // On récupère la classe composante
-    if (compo_index < 0 || compo_index >= part->size) return NULL;
-
-    TarjanClass cls = part->classes[compo_index];
-    int k = cls.size;    // nombre d’états dans la composante
+    if (compo_index < 0 || compo_index >= part->size) {
+        Matrix empty = { 0, 0, NULL };
+        return empty;
+    }
 
-    // Renvoie la taille de la sous-matrice
-    *out_n = k;
+    // membres et taille pris sur la même classe (après partition_finalize,
+    // members pointe déjà dans le tableau à plat)
+    const TarjanClass *C = &part->classes[compo_index];
+    return subMatrixStates(matrix, C->members, C->size);
+}
 
+Matrix subMatrixStates(const Matrix *matrix, const int *states, int k)
+{
     // Allocation k × k
-    float **S = matrix_create(k);
+    Matrix S = matrix_create(k);
 
     // Remplissage de la sous-matrice :
-    // On garde uniquement les lignes et colonnes appartenant à la composante
+    // On garde uniquement les lignes et colonnes des états demandés
     for (int i = 0; i < k; i++) {
-        int original_i = cls.members[i];   // numéro réel du sommet
+        const prob_t *src = &MAT(matrix, states[i] - 1, 0);   // ligne réelle
+        prob_t *dst = &MAT(&S, i, 0);
 
         for (int j = 0; j < k; j++) {
-            int original_j = cls.members[j];
-
-            S[i][j] = matrix[original_i - 1][original_j - 1];
+            dst[j] = src[states[j] - 1];
         }
     }
 
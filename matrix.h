@@ -8,37 +8,134 @@
 #include "tarjan.h"
 
 
+// =====================
+//   Type matrice
+// =====================
+
+// Largeur de bande du noyau de multiplication (en éléments) :
+// chaque ligne est complétée par des zéros jusqu'à un multiple de cette valeur
+#define MATRIX_STRIP 64
+
+// Matrice n×n stockée en un seul bloc, ligne par ligne, aligné sur 64 octets
+typedef struct {
+    int    n;      // dimension
+    int    ld;     // pas entre deux lignes (n arrondi à MATRIX_STRIP)
+    prob_t *data;  // n × ld valeurs, colonnes n..ld-1 toujours nulles
+} Matrix;
+
+// Élément (i, j), indices 0-based
+#define MAT(M, i, j) ((M)->data[(size_t)(i) * (M)->ld + (j)])
+
+
 // =====================
 //   Création / Free
 // =====================
 
 // Crée une matrice n×n initialisée à 0
-float **matrix_create(int n);
+Matrix matrix_create(int n);
 
 // Libère une matrice
-void matrix_free(float **M, int n);
+void matrix_free(Matrix *M);
 
-// Copie une matrice source → destination
-void matrix_copy(float **dest, float **src, int n);
+// Copie une matrice source → destination (même dimension)
+void matrix_copy(Matrix *dest, const Matrix *src);
 
 // =====================
 //   Opérations
 // =====================
 
 // Convertit un graphe en matrice de probabilités (n×n)
-float **matrix_from_graph(const AdjList *G);
+Matrix matrix_from_graph(const AdjList *G);
+
+// Même conversion à partir du graphe CSR
+Matrix matrix_from_csr(const CsrGraph *G);
+
+// Multiplication matricielle R = A × B (par blocs, vectorisée AVX2/AVX-512
+// si le processeur le permet, sinon version scalaire). Les sommes partielles
+// sont faites en acc_t : en mode mixed, les float sont convertis en double
+// à la volée et R n'est arrondi en float qu'à la fin de chaque bloc de k.
+void matrix_mult(const Matrix *A, const Matrix *B, Matrix *R);
+
+// Puissance M^k par exponentiation rapide (O(log k) multiplications).
+// Trois tampons alloués une fois, échangés par pointeur : aucune allocation
+// par étape. La matrice renvoyée est à libérer par matrix_free. k >= 0.
+Matrix matrix_pow(const Matrix *M, int k);
 
-// Multiplication matricielle R = A × B
-void matrix_mult(float **A, float **B, float **R, int n);
+// Nom du noyau choisi à l'exécution ("avx512", "avx2" ou "scalar")
+// (la précision de compilation est MARKOV_PRECISION_NAME)
+const char *matrix_kernel_name(void);
 
-// Différence absolue entre deux matrices
-float matrix_diff(float **A, float **B, int n);
+// Différence absolue entre deux matrices (accumulée en acc_t)
+acc_t matrix_diff(const Matrix *A, const Matrix *B);
+
+// R = A × B avec l'écart à ref calculé dans le noyau, pendant le dernier
+// bloc de k (pas de second passage sur R) : row_l1[i] = somme des
+// |R_ij - ref_ij| de la ligne i, row_max[i] = leur max (n valeurs chacun).
+// ref peut être A ou B, pas R.
+void matrix_mult_diff(const Matrix *A, const Matrix *B, Matrix *R,
+                      const Matrix *ref, acc_t *row_l1, acc_t *row_max);
+
+// Critère d'arrêt du pilote de convergence
+typedef enum {
+    CONV_L1,     // somme de tous les |écarts| (celle de matrix_diff)
+    CONV_LINF,   // plus grand |écart|
+    CONV_ROW     // chaque ligne : somme de ses |écarts| < tol
+} ConvergenceNorm;
+
+typedef struct {
+    ConvergenceNorm norm;
+    acc_t tol;
+    int   max_iter;      // itérations sans convergence avant abandon
+    int   check_every;   // écart mesuré un produit sur check_every (>= 1)
+} ConvergenceOptions;
+
+// CONV_L1, tol = 0.01, max_iter = 1000, check_every = 1
+ConvergenceOptions convergence_default_options(void);
+
+typedef struct {
+    int   iterations;  // produits avant le dernier (max_iter + 1 produits au plus)
+    int   checks;      // écarts mesurés
+    int   converged;   // 1 si l'écart est passé sous tol
+    acc_t diff;        // dernier écart mesuré, selon norm
+    int   worst_row;   // ligne (0-based) du plus grand écart à ce moment
+} ConvergenceReport;
+
+/*
+   Pilote de convergence : X <- X × Q depuis X = X0 jusqu'à ce que l'écart
+   entre deux itérés passe sous opt->tol (NULL : options par défaut).
+   Deux tampons échangés par pointeur (aucune copie par itération) et
+   écart fusionné dans la multiplication (matrix_mult_diff) ; entre deux
+   mesures, simple matrix_mult. Renvoie le dernier itéré (à libérer).
+*/
+Matrix matrix_converge(const Matrix *X0, const Matrix *Q, const ConvergenceOptions *opt,
+                       ConvergenceReport *rep);
+
+// Bilan de matrix_limit
+typedef struct {
+    int   period;      // pas utilisé (M^period itérée)
+    int   iterations;  // multiplications par M^period avant convergence
+    int   converged;   // 1 si l'écart est passé sous tol avant max_iter
+    acc_t diff;        // dernier écart entre deux itérés
+} MatrixLimitReport;
+
+// Limite de M^n. Si period > 1 (chaîne périodique, cf. classification_period)
+// la suite M^n oscille : on itère Q = M^period, dont les puissances
+// convergent, puis on renvoie la moyenne de Cesàro sur une période
+// (A + A M + ... + A M^(period-1)) / period. period <= 0 : période
+// inconnue ou trop grande, rien n'est itéré (converged = 0, copie de M).
+// Itération par matrix_converge avec opt (NULL : options par défaut).
+// La matrice renvoyée est à libérer.
+Matrix matrix_limit(const Matrix *M, int period, const ConvergenceOptions *opt, MatrixLimitReport *rep);
 
 // Affichage pour debug
-void matrix_print(float **M, int n);
+void matrix_print(const Matrix *M);
 // =========================================================
 // Sous-matrice correspondant à une composante fortement connexe
+// (matrice vide, n = 0, si l'indice de composante est invalide)
 // =========================================================
-float **subMatrix(float **matrix, const TarjanPartition *part, int compo_index, int *out_n);
+Matrix subMatrix(const Matrix *matrix, const TarjanPartition *part, int compo_index);
+
+// Sous-matrice des k états states[] (numérotés à partir de 1), dans cet ordre
+Matrix subMatrixStates(const Matrix *matrix, const int *states, int k);
 
 #endif
@@ -0,0 +1,40 @@
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+/*
+   Type numérique des probabilités, choisi à la compilation
+   (option CMake MARKOV_PRECISION, ou -DMARKOV_PRECISION=... à la main) :
+
+     MARKOV_FLOAT  : stockage float,  calculs en float   (moins de mémoire)
+     MARKOV_DOUBLE : stockage double, calculs en double  (plus précis)
+     MARKOV_MIXED  : stockage float,  sommes en double   (bande passante du
+                     float, erreurs d’arrondi proches du double)
+
+   prob_t est le type stocké (graphes, matrices, distributions),
+   acc_t celui des accumulateurs (sommes de lignes, produits, écarts).
+*/
+#define MARKOV_FLOAT  0
+#define MARKOV_DOUBLE 1
+#define MARKOV_MIXED  2
+
+#ifndef MARKOV_PRECISION
+#define MARKOV_PRECISION MARKOV_FLOAT
+#endif
+
+#if MARKOV_PRECISION == MARKOV_DOUBLE
+typedef double prob_t;
+typedef double acc_t;
+#define MARKOV_PRECISION_NAME "double"
+#elif MARKOV_PRECISION == MARKOV_MIXED
+typedef float  prob_t;
+typedef double acc_t;
+#define MARKOV_PRECISION_NAME "mixed"
+#elif MARKOV_PRECISION == MARKOV_FLOAT
+typedef float  prob_t;
+typedef float  acc_t;
+#define MARKOV_PRECISION_NAME "float"
+#else
+#error "MARKOV_PRECISION doit valoir MARKOV_FLOAT, MARKOV_DOUBLE ou MARKOV_MIXED"
+#endif
+
+#endif // NUMERIC_H
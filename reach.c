@@ -0,0 +1,264 @@
+#include "reach.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define REACH_X86 1
+#include <immintrin.h>
+#endif
+
+
+// ---------- OR de bitsets ----------
+static void or_scalar(uint64_t *dst, const uint64_t *src, size_t nw) {
+    for (size_t w = 0; w < nw; ++w) dst[w] |= src[w];
+}
+
+#ifdef REACH_X86
+__attribute__((target("avx2")))
+static void or_avx2(uint64_t *dst, const uint64_t *src, size_t nw) {
+    size_t w = 0;
+    for (; w + 4 <= nw; w += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + w));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + w));
+        _mm256_storeu_si256((__m256i*)(dst + w), _mm256_or_si256(a, b));
+    }
+    for (; w < nw; ++w) dst[w] |= src[w];
+}
+
+__attribute__((target("avx512f")))
+static void or_avx512(uint64_t *dst, const uint64_t *src, size_t nw) {
+    size_t w = 0;
+    for (; w + 8 <= nw; w += 8) {
+        __m512i a = _mm512_loadu_si512(dst + w);
+        __m512i b = _mm512_loadu_si512(src + w);
+        _mm512_storeu_si512(dst + w, _mm512_or_si512(a, b));
+    }
+    for (; w < nw; ++w) dst[w] |= src[w];
+}
+#endif
+
+void bitset_or(uint64_t *dst, const uint64_t *src, size_t nw) {
+#ifdef REACH_X86
+    if (nw >= 8 && __builtin_cpu_supports("avx512f")) {
+        or_avx512(dst, src, nw);
+        return;
+    }
+    if (nw >= 4 && __builtin_cpu_supports("avx2")) {
+        or_avx2(dst, src, nw);
+        return;
+    }
+#endif
+    or_scalar(dst, src, nw);
+}
+
+
+// ---------- Graphe des classes ----------
+// Liens sortants de chaque classe (CSR) et ordre topologique (Kahn).
+// Renvoie 0 si les liens forment un cycle.
+static int class_graph(const t_link_array *L, int C, int **p_start, int **p_succ, int **p_topo) {
+    int *start = (int*)calloc((size_t)C + 1, sizeof(int));
+    int *succ = (int*)malloc((L->size > 0 ? L->size : 1) * sizeof(int));
+    int *indeg = (int*)calloc(C > 0 ? C : 1, sizeof(int));
+    int *topo = (int*)malloc((C > 0 ? C : 1) * sizeof(int));
+    if (!start || !succ || !indeg || !topo) {
+        perror("malloc class graph");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < L->size; ++i) {
+        start[L->data[i].from + 1]++;
+        indeg[L->data[i].to]++;
+    }
+    for (int c = 0; c < C; ++c) start[c + 1] += start[c];
+    int *fill = topo;   // sert de curseur avant de recevoir l’ordre
+    for (int c = 0; c < C; ++c) fill[c] = start[c];
+    for (int i = 0; i < L->size; ++i) succ[fill[L->data[i].from]++] = L->data[i].to;
+
+    int head = 0, tail = 0;
+    for (int c = 0; c < C; ++c)
+        if (indeg[c] == 0) topo[tail++] = c;
+    while (head < tail) {
+        int u = topo[head++];
+        for (int k = start[u]; k < start[u + 1]; ++k)
+            if (--indeg[succ[k]] == 0) topo[tail++] = succ[k];
+    }
+    free(indeg);
+
+    *p_start = start;
+    *p_succ = succ;
+    *p_topo = topo;
+    return tail == C;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+
+// ---------- Construction ----------
+static ReachIndex reach_empty(void) {
+    ReachIndex R;
+    R.nclasses = 0;
+    R.sparse = 0;
+    R.words = 0;
+    R.bits = NULL;
+    R.start = NULL;
+    R.slot = NULL;
+    R.list = NULL;
+    return R;
+}
+
+// Lignes de bits, de la dernière classe topologique à la première
+static void build_dense(ReachIndex *R, const int *start, const int *succ, const int *topo) {
+    int C = R->nclasses;
+    R->words = ((size_t)C + 63) / 64;
+    R->bits = (uint64_t*)calloc((size_t)C * R->words, sizeof(uint64_t));
+    if (!R->bits) {
+        perror("calloc reach bits");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = C - 1; t >= 0; --t) {
+        int u = topo[t];
+        uint64_t *ru = R->bits + (size_t)u * R->words;
+        ru[u >> 6] |= 1ULL << (u & 63);
+        for (int k = start[u]; k < start[u + 1]; ++k)
+            bitset_or(ru, R->bits + (size_t)succ[k] * R->words, R->words);
+    }
+}
+
+// Place pour une entrée de plus dans R->list (doublement, jamais plus de
+// limit places) ; 0 si le budget est atteint
+static int list_grow(ReachIndex *R, int64_t *capacity, int64_t size, int64_t limit) {
+    if (size < *capacity) return 1;
+    if (*capacity >= limit) return 0;
+    int64_t nc = *capacity < 8 ? 8 : *capacity * 2;
+    if (nc > limit) nc = limit;
+    int *nl = (int*)realloc(R->list, (size_t)nc * sizeof(int));
+    if (!nl) {
+        perror("realloc reach index");
+        exit(EXIT_FAILURE);
+    }
+    R->list = nl;
+    *capacity = nc;
+    return 1;
+}
+
+/*
+   Listes triées : union des listes des successeurs (marquage par tampon).
+   Chaque ligne est écrite directement à la suite dans R->list, dans
+   l’ordre du calcul (topologique inverse), puis triée sur place ; slot[c]
+   donne le rang de la ligne de c. La taille est suivie en cours de route :
+   dès que l’index dépasserait max_bytes, on abandonne et on renvoie 0.
+*/
+static int build_sparse(ReachIndex *R, const int *start, const int *succ, const int *topo,
+                        size_t max_bytes) {
+    int C = R->nclasses;
+    size_t fixed = ((size_t)C + 1) * sizeof(int64_t) + (size_t)C * sizeof(int);
+    if (fixed > max_bytes) return 0;
+    int64_t limit = (int64_t)((max_bytes - fixed) / sizeof(int));
+
+    R->start = (int64_t*)malloc(((size_t)C + 1) * sizeof(int64_t));
+    R->slot = (int*)malloc((size_t)C * sizeof(int));
+    int *stamp = (int*)malloc((size_t)C * sizeof(int));
+    if (!R->start || !R->slot || !stamp) {
+        perror("malloc reach lists");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < C; ++c) stamp[c] = -1;
+
+    int64_t size = 0, capacity = 0;
+    int fits = 1;
+    R->start[0] = 0;
+    for (int t = C - 1; t >= 0 && fits; --t) {
+        int u = topo[t];
+        int64_t end = size;
+        fits = list_grow(R, &capacity, end, limit);
+        if (!fits) break;
+        stamp[u] = u;
+        R->list[end++] = u;
+        for (int e = start[u]; e < start[u + 1] && fits; ++e) {
+            int s = R->slot[succ[e]];
+            for (int64_t i = R->start[s]; i < R->start[s + 1]; ++i) {
+                int w = R->list[i];
+                if (stamp[w] == u) continue;
+                stamp[w] = u;
+                fits = list_grow(R, &capacity, end, limit);
+                if (!fits) break;
+                R->list[end++] = w;
+            }
+        }
+        if (!fits) break;
+        qsort(R->list + size, (size_t)(end - size), sizeof(int), cmp_int);
+        R->slot[u] = C - 1 - t;
+        R->start[C - t] = end;
+        size = end;
+    }
+    free(stamp);
+    return fits;
+}
+
+ReachIndex reach_build(const TarjanPartition *P, const t_link_array *L, size_t max_bytes) {
+    ReachIndex R = reach_empty();
+    int C = P->size;
+    if (C <= 0) return R;
+
+    int *start, *succ, *topo;
+    if (!class_graph(L, C, &start, &succ, &topo)) {
+        fprintf(stderr, "reach_build : le graphe des classes contient un cycle\n");
+        free(start);
+        free(succ);
+        free(topo);
+        return R;
+    }
+
+    R.nclasses = C;
+    size_t dense_bytes = (size_t)C * (((size_t)C + 63) / 64) * sizeof(uint64_t);
+    if (max_bytes == 0 || dense_bytes <= max_bytes) build_dense(&R, start, succ, topo);
+    else {
+        R.sparse = 1;
+        if (!build_sparse(&R, start, succ, topo, max_bytes)) {
+            fprintf(stderr, "reach_build : la fermeture transitive depasse le budget "
+                            "(%zu octets) en dense comme en creux\n", max_bytes);
+            reach_free(&R);
+        }
+    }
+
+    free(start);
+    free(succ);
+    free(topo);
+    return R;
+}
+
+
+// ---------- Requêtes ----------
+int class_reaches(const ReachIndex *R, int a, int b) {
+    if (a < 0 || b < 0 || a >= R->nclasses || b >= R->nclasses) return 0;
+    if (!R->sparse)
+        return (int)((R->bits[(size_t)a * R->words + (b >> 6)] >> (b & 63)) & 1);
+
+    int s = R->slot[a];
+    int64_t lo = R->start[s], hi = R->start[s + 1];
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (R->list[mid] < b) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < R->start[s + 1] && R->list[lo] == b;
+}
+
+size_t reach_memory(const ReachIndex *R) {
+    if (R->nclasses == 0) return 0;
+    if (!R->sparse) return (size_t)R->nclasses * R->words * sizeof(uint64_t);
+    return ((size_t)R->nclasses + 1) * sizeof(int64_t)
+         + (size_t)R->nclasses * sizeof(int)
+         + (size_t)R->start[R->nclasses] * sizeof(int);
+}
+
+void reach_free(ReachIndex *R) {
+    if (!R) return;
+    free(R->bits);
+    free(R->start);
+    free(R->slot);
+    free(R->list);
+    *R = reach_empty();
+}
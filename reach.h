@@ -0,0 +1,51 @@
+#ifndef REACH_H
+#define REACH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tarjan.h"
+
+/*
+   Index d’accessibilité entre classes (graphe condensé de la partition).
+
+   Représentation dense : une ligne de bits par classe, words mots de
+   64 bits par ligne, soit nclasses × words × 8 ≈ nclasses² / 8 octets.
+   Les lignes sont calculées dans l’ordre topologique inverse :
+   reach[u] = OR des reach[v] (+ v) pour chaque lien u -> v, OR vectorisé.
+
+   Représentation creuse (si la matrice dense dépasse le budget demandé) :
+   pour chaque classe la liste triée des classes accessibles, requête par
+   recherche dichotomique. 4 octets par paire accessible (32 fois le bit
+   du dense) : elle n’est plus petite que si la fermeture est creuse. Sa
+   taille est suivie pendant la construction et reste dans le budget.
+*/
+typedef struct {
+    int       nclasses;
+    int       sparse;     // 0 : bits dense, 1 : listes triées
+    size_t    words;      // mots de 64 bits par ligne (dense)
+    uint64_t *bits;       // nclasses × words (dense)
+    int64_t  *start;      // nclasses + 1 offsets des lignes dans list (creux)
+    int      *slot;       // rang de la ligne de chaque classe (creux)
+    int      *list;       // classes accessibles, triées par ligne (creux)
+} ReachIndex;
+
+// Construit l’index à partir des liens entre classes de P.
+// max_bytes : budget mémoire de l’index (0 : toujours dense). Si la matrice
+// dense le dépasse, l’index creux est construit dans ce même budget. Si les
+// liens forment un cycle, ou si l’index creux dépasse aussi le budget,
+// l’index renvoyé est vide (nclasses = 0) et un message est affiché.
+ReachIndex reach_build(const TarjanPartition *P, const t_link_array *L, size_t max_bytes);
+
+// 1 si la classe a mène à la classe b (chemin de longueur >= 0), 0 sinon.
+// O(1) en dense, O(log k) en creux.
+int class_reaches(const ReachIndex *R, int a, int b);
+
+// Mémoire occupée par l’index (octets)
+size_t reach_memory(const ReachIndex *R);
+
+void reach_free(ReachIndex *R);
+
+// dst[0..nw) |= src[0..nw), AVX-512/AVX2 si le processeur le permet
+void bitset_or(uint64_t *dst, const uint64_t *src, size_t nw);
+
+#endif // REACH_H
@@ -0,0 +1,583 @@
+#include "scc.h"
+#include "threadpool.h"
+#include <stdatomic.h>
+
+// Nombre maximal de passes d’élagage parallèle (le reste est élagué par tâche)
+#define SCC_TRIM_ROUNDS 4
+// Taille à partir de laquelle un sous-ensemble devient une tâche du pool ;
+// en dessous, il est résolu par un Tarjan local plutôt que par forward-backward
+#define SCC_TASK_SPAWN  4096
+// En dessous, un niveau de BFS est traité sans passer par le pool
+#define SCC_BFS_PARALLEL_MIN 1024
+
+#define MARK_FW    1
+#define MARK_BW    2
+#define MARK_STACK 4   // sommet dans la pile du Tarjan local
+
+// État partagé par tous les threads
+typedef struct {
+    const CsrGraph  *G;          // arcs sortants
+    CsrGraph         T;          // arcs entrants
+    atomic_int      *color;      // tâche du sommet, -1 quand sa SCC est connue
+    int             *comp;       // numéro de SCC du sommet
+    atomic_uchar    *mark;       // bits MARK_FW / MARK_BW
+    int             *deg_in;     // degrés restants (élagage), index (Tarjan local)
+    int             *deg_out;    // degrés restants (élagage), lowlink (Tarjan local)
+    int64_t         *cursor;     // position dans la ligne CSR (Tarjan local)
+    atomic_int       next_comp;  // prochain numéro de SCC
+    atomic_int       next_color; // prochaine couleur (tâche)
+    ThreadPool       pool;
+    IntStack        *local;      // un tampon par morceau de boucle parallèle
+    atomic_llong     counter;    // compteur partagé (sommets élagués)
+} SccContext;
+
+// Sous-ensemble de sommets de même couleur, traité indépendamment
+typedef struct SccTask {
+    SccContext *ctx;
+    int         color;
+    int        *verts;
+    int         size;
+} SccTask;
+
+
+// ---------- Accès aux tableaux partagés ----------
+static inline int get_color(SccContext *X, int v) {
+    return atomic_load_explicit(&X->color[v], memory_order_relaxed);
+}
+
+static inline void set_color(SccContext *X, int v, int c) {
+    atomic_store_explicit(&X->color[v], c, memory_order_relaxed);
+}
+
+// Range v dans la composante c (il sort de sa tâche)
+static inline void scc_assign(SccContext *X, int v, int c) {
+    X->comp[v] = c;
+    set_color(X, v, -1);
+}
+
+static inline int new_comp(SccContext *X) {
+    return atomic_fetch_add_explicit(&X->next_comp, 1, memory_order_relaxed);
+}
+
+static inline int new_color(SccContext *X) {
+    return atomic_fetch_add_explicit(&X->next_color, 1, memory_order_relaxed);
+}
+
+// 1 si v a un voisin w != v de couleur c dans le graphe H
+static int has_live_neighbor(SccContext *X, const CsrGraph *H, int v, int c) {
+    for (int64_t k = H->row[v]; k < H->row[v + 1]; ++k) {
+        int w = H->dest[k];
+        if (w != v && get_color(X, w) == c) return 1;
+    }
+    return 0;
+}
+
+
+// ============================================================================
+//  Phase 1 : travail parallèle sur la couleur 0 (tout le graphe)
+// ============================================================================
+
+// Une passe d’élagage : sommet sans arc entrant ou sortant → SCC triviale
+static void trim_range(int64_t begin, int64_t end, int chunk, void *arg) {
+    (void)chunk;
+    SccContext *X = (SccContext*)arg;
+    long long removed = 0;
+    for (int64_t i = begin; i < end; ++i) {
+        int v = (int)i + 1;
+        if (get_color(X, v) != 0) continue;
+        if (!has_live_neighbor(X, X->G, v, 0) || !has_live_neighbor(X, &X->T, v, 0)) {
+            scc_assign(X, v, new_comp(X));
+            removed++;
+        }
+    }
+    atomic_fetch_add(&X->counter, removed);
+}
+
+// Pivot : sommet vivant de plus grand produit degré entrant × sortant
+typedef struct {
+    SccContext *ctx;
+    int        *best;        // un candidat par morceau
+} PivotArgs;
+
+static void pivot_range(int64_t begin, int64_t end, int chunk, void *arg) {
+    PivotArgs *A = (PivotArgs*)arg;
+    SccContext *X = A->ctx;
+    int best = -1;
+    int64_t best_score = -1;
+    for (int64_t i = begin; i < end; ++i) {
+        int v = (int)i + 1;
+        if (get_color(X, v) != 0) continue;
+        int64_t score = (X->G->row[v + 1] - X->G->row[v]) * (X->T.row[v + 1] - X->T.row[v]);
+        if (score > best_score) {
+            best_score = score;
+            best = v;
+        }
+    }
+    A->best[chunk] = best;
+}
+
+// BFS par niveaux : chaque morceau de la frontière remplit son propre tampon
+typedef struct {
+    SccContext     *ctx;
+    const CsrGraph *H;
+    const int      *frontier;
+    unsigned char   bit;
+} BfsArgs;
+
+static void bfs_range(int64_t begin, int64_t end, int chunk, void *arg) {
+    BfsArgs *A = (BfsArgs*)arg;
+    SccContext *X = A->ctx;
+    IntStack *out = &X->local[chunk];
+    for (int64_t i = begin; i < end; ++i) {
+        int u = A->frontier[i];
+        for (int64_t k = A->H->row[u]; k < A->H->row[u + 1]; ++k) {
+            int w = A->H->dest[k];
+            if (get_color(X, w) != 0) continue;
+            if (atomic_load_explicit(&X->mark[w], memory_order_relaxed) & A->bit) continue;
+            // le premier thread qui pose le bit ajoute w à la frontière
+            unsigned char old = atomic_fetch_or_explicit(&X->mark[w], A->bit, memory_order_relaxed);
+            if (!(old & A->bit)) stack_push(out, w);
+        }
+    }
+}
+
+static void parallel_bfs(SccContext *X, const CsrGraph *H, int pivot, unsigned char bit) {
+    IntStack frontier = stack_create(64);
+    stack_push(&frontier, pivot);
+    atomic_fetch_or(&X->mark[pivot], bit);
+
+    BfsArgs A = { X, H, NULL, bit };
+    while (!stack_empty(&frontier)) {
+        A.frontier = frontier.data;
+        // petite frontière (graphe de grand diamètre) : pas de synchronisation
+        if (frontier.top < SCC_BFS_PARALLEL_MIN)
+            bfs_range(0, frontier.top, 0, &A);
+        else
+            pool_parallel_for(&X->pool, frontier.top, bfs_range, &A);
+
+        // la nouvelle frontière est la concaténation des tampons
+        frontier.top = 0;
+        for (int c = 0; c < X->pool.nthreads; ++c) {
+            IntStack *L = &X->local[c];
+            for (int i = 0; i < L->top; ++i) stack_push(&frontier, L->data[i]);
+            L->top = 0;
+        }
+    }
+    stack_free(&frontier);
+}
+
+
+// ============================================================================
+//  Phase 2 : tâches indépendantes (une couleur chacune), séquentielles
+// ============================================================================
+
+static void task_run(void *arg);
+
+static SccTask *task_create(SccContext *X, int color, int *verts, int size) {
+    SccTask *T = (SccTask*)malloc(sizeof(SccTask));
+    if (!T) {
+        perror("malloc scc task");
+        exit(EXIT_FAILURE);
+    }
+    T->ctx = X;
+    T->color = color;
+    T->verts = verts;
+    T->size = size;
+    return T;
+}
+
+// Élagage complet d’une tâche : retire en cascade les sommets de degré nul
+static void task_trim(SccTask *T) {
+    SccContext *X = T->ctx;
+    int c = T->color;
+    IntStack Q = stack_create(64);
+
+    for (int i = 0; i < T->size; ++i) {
+        int v = T->verts[i];
+        int dout = 0, din = 0;
+        for (int64_t k = X->G->row[v]; k < X->G->row[v + 1]; ++k) {
+            int w = X->G->dest[k];
+            if (w != v && get_color(X, w) == c) dout++;
+        }
+        for (int64_t k = X->T.row[v]; k < X->T.row[v + 1]; ++k) {
+            int w = X->T.dest[k];
+            if (w != v && get_color(X, w) == c) din++;
+        }
+        X->deg_out[v] = dout;
+        X->deg_in[v] = din;
+        if (dout == 0 || din == 0) stack_push(&Q, v);
+    }
+
+    while (!stack_empty(&Q)) {
+        int v = stack_pop(&Q);
+        if (get_color(X, v) != c) continue;   // déjà retiré
+        scc_assign(X, v, new_comp(X));
+
+        for (int64_t k = X->G->row[v]; k < X->G->row[v + 1]; ++k) {
+            int w = X->G->dest[k];
+            if (w != v && get_color(X, w) == c && --X->deg_in[w] == 0) stack_push(&Q, w);
+        }
+        for (int64_t k = X->T.row[v]; k < X->T.row[v + 1]; ++k) {
+            int w = X->T.dest[k];
+            if (w != v && get_color(X, w) == c && --X->deg_out[w] == 0) stack_push(&Q, w);
+        }
+    }
+    stack_free(&Q);
+
+    // compactage : on ne garde que les sommets encore dans la tâche
+    int k = 0;
+    for (int i = 0; i < T->size; ++i)
+        if (get_color(X, T->verts[i]) == c) T->verts[k++] = T->verts[i];
+    T->size = k;
+}
+
+// Parcours séquentiel depuis pivot dans la couleur c, pose le bit
+static void task_bfs(SccContext *X, const CsrGraph *H, int pivot, int c, unsigned char bit, IntStack *Q) {
+    Q->top = 0;
+    stack_push(Q, pivot);
+    atomic_fetch_or_explicit(&X->mark[pivot], bit, memory_order_relaxed);
+    while (!stack_empty(Q)) {
+        int u = stack_pop(Q);
+        for (int64_t k = H->row[u]; k < H->row[u + 1]; ++k) {
+            int w = H->dest[k];
+            if (get_color(X, w) != c) continue;
+            if (atomic_load_explicit(&X->mark[w], memory_order_relaxed) & bit) continue;
+            atomic_fetch_or_explicit(&X->mark[w], bit, memory_order_relaxed);
+            stack_push(Q, w);
+        }
+    }
+}
+
+// Répartit les sommets restants selon leurs marques, puis les efface
+static void split_by_marks(SccContext *X, const int *verts, int size, int scc_id,
+                           int *parts[3], int counts[3]) {
+    for (int p = 0; p < 3; ++p) {
+        parts[p] = (int*)malloc((size > 0 ? size : 1) * sizeof(int));
+        if (!parts[p]) {
+            perror("malloc scc split");
+            exit(EXIT_FAILURE);
+        }
+        counts[p] = 0;
+    }
+
+    for (int i = 0; i < size; ++i) {
+        int v = verts[i];
+        unsigned char m = atomic_load_explicit(&X->mark[v], memory_order_relaxed);
+        atomic_store_explicit(&X->mark[v], 0, memory_order_relaxed);
+        if (m == (MARK_FW | MARK_BW)) scc_assign(X, v, scc_id);
+        else if (m == MARK_FW)        parts[0][counts[0]++] = v;
+        else if (m == MARK_BW)        parts[1][counts[1]++] = v;
+        else                          parts[2][counts[2]++] = v;
+    }
+}
+
+// Donne une couleur neuve à chaque sous-ensemble et le confie au pool
+// (ou à la pile locale s’il est petit)
+static void dispatch_parts(SccContext *X, int *parts[3], int counts[3], SccTask **stack, int *top) {
+    for (int p = 0; p < 3; ++p) {
+        if (counts[p] == 0) {
+            free(parts[p]);
+            continue;
+        }
+        int c = new_color(X);
+        for (int i = 0; i < counts[p]; ++i) set_color(X, parts[p][i], c);
+        SccTask *T = task_create(X, c, parts[p], counts[p]);
+        if (stack && counts[p] < SCC_TASK_SPAWN) stack[(*top)++] = T;
+        else pool_submit(&X->pool, task_run, T);
+    }
+}
+
+/*
+   Tarjan itératif limité aux sommets de la couleur de la tâche
+   (même schéma que tarjan_run_csr ; index/lowlink sont rangés dans deg_in/deg_out).
+   Les arcs vers une autre couleur sont ignorés : ces sommets appartiennent
+   à d’autres tâches, ou à des SCC déjà trouvées.
+*/
+static void task_tarjan(SccTask *T, IntStack *S, IntStack *calls) {
+    SccContext *X = T->ctx;
+    const CsrGraph *G = X->G;
+    int c = T->color;
+    int *idx = X->deg_in;
+    int *low = X->deg_out;
+    int counter = 0;
+
+    for (int i = 0; i < T->size; ++i) idx[T->verts[i]] = -1;
+
+    for (int i = 0; i < T->size; ++i) {
+        int root = T->verts[i];
+        if (get_color(X, root) != c || idx[root] != -1) continue;
+
+        idx[root] = low[root] = counter++;
+        X->cursor[root] = G->row[root];
+        stack_push(S, root);
+        atomic_fetch_or_explicit(&X->mark[root], MARK_STACK, memory_order_relaxed);
+        stack_push(calls, root);
+
+        while (!stack_empty(calls)) {
+            int u = stack_peek(calls);
+
+            if (X->cursor[u] < G->row[u + 1]) {
+                int w = G->dest[X->cursor[u]++];
+                if (get_color(X, w) != c) continue;
+                if (idx[w] == -1) {
+                    idx[w] = low[w] = counter++;
+                    X->cursor[w] = G->row[w];
+                    stack_push(S, w);
+                    atomic_fetch_or_explicit(&X->mark[w], MARK_STACK, memory_order_relaxed);
+                    stack_push(calls, w);
+                } else if ((atomic_load_explicit(&X->mark[w], memory_order_relaxed) & MARK_STACK)
+                           && idx[w] < low[u]) {
+                    low[u] = idx[w];
+                }
+            } else {
+                stack_pop(calls);
+                if (low[u] == idx[u]) {
+                    int id = new_comp(X);
+                    while (!stack_empty(S)) {
+                        int w = stack_pop(S);
+                        atomic_store_explicit(&X->mark[w], 0, memory_order_relaxed);
+                        scc_assign(X, w, id);
+                        if (w == u) break;
+                    }
+                }
+                if (!stack_empty(calls)) {
+                    int parent = stack_peek(calls);
+                    if (low[u] < low[parent]) low[parent] = low[u];
+                }
+            }
+        }
+    }
+}
+
+// Forward-backward séquentiel ; les petits sous-problèmes restent sur ce thread
+static void task_run(void *arg) {
+    SccTask *first = (SccTask*)arg;
+    SccContext *X = first->ctx;
+    IntStack Q = stack_create(64);
+    IntStack calls = stack_create(64);
+
+    // chaque découpe ajoute au plus 3 tâches et en retire une
+    int cap = 64, top = 0;
+    SccTask **stack = (SccTask**)malloc(cap * sizeof(SccTask*));
+    if (!stack) {
+        perror("malloc scc task stack");
+        exit(EXIT_FAILURE);
+    }
+    stack[top++] = first;
+
+    while (top > 0) {
+        SccTask *T = stack[--top];
+        if (T->size >= SCC_TASK_SPAWN) task_trim(T);
+
+        if (T->size > 0 && T->size < SCC_TASK_SPAWN) {
+            task_tarjan(T, &Q, &calls);
+        } else if (T->size > 0) {
+            // pivot pseudo-aléatoire : sur une chaîne de SCC, un pivot fixe
+            // ne détacherait qu’une composante à chaque découpe
+            unsigned int h = (unsigned int)T->color * 2654435761u;
+            int pivot = T->verts[(h ^ (h >> 16)) % (unsigned int)T->size];
+            task_bfs(X, X->G, pivot, T->color, MARK_FW, &Q);
+            task_bfs(X, &X->T, pivot, T->color, MARK_BW, &Q);
+
+            int *parts[3], counts[3];
+            split_by_marks(X, T->verts, T->size, new_comp(X), parts, counts);
+
+            if (top + 3 > cap) {
+                cap *= 2;
+                SccTask **ns = (SccTask**)realloc(stack, cap * sizeof(SccTask*));
+                if (!ns) {
+                    perror("realloc scc task stack");
+                    exit(EXIT_FAILURE);
+                }
+                stack = ns;
+            }
+            dispatch_parts(X, parts, counts, stack, &top);
+        }
+        free(T->verts);
+        free(T);
+    }
+
+    free(stack);
+    stack_free(&calls);
+    stack_free(&Q);
+}
+
+
+// ============================================================================
+//  Assemblage de la partition (ordre topologique inverse, comme Tarjan)
+// ============================================================================
+
+static TarjanPartition build_partition(const CsrGraph *G, const int *comp, int ncomp) {
+    int n = G->n;
+
+    // membres regroupés par composante (tri par comptage, sommets croissants)
+    int64_t *start = (int64_t*)calloc((size_t)ncomp + 1, sizeof(int64_t));
+    int *members = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    int *indeg = (int*)calloc((size_t)ncomp + 1, sizeof(int));
+    int *order = (int*)malloc(((size_t)ncomp + 1) * sizeof(int));
+    if (!start || !members || !indeg || !order) {
+        perror("malloc scc partition");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 1; v <= n; ++v) start[comp[v] + 1]++;
+    for (int c = 0; c < ncomp; ++c) start[c + 1] += start[c];
+    {
+        int64_t *pos = (int64_t*)malloc(((size_t)ncomp + 1) * sizeof(int64_t));
+        if (!pos) {
+            perror("malloc scc partition");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(pos, start, ((size_t)ncomp + 1) * sizeof(int64_t));
+        for (int v = 1; v <= n; ++v) members[pos[comp[v]]++] = v;
+        free(pos);
+    }
+
+    // tri topologique (Kahn) du graphe réduit
+    for (int u = 1; u <= n; ++u)
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k)
+            if (comp[G->dest[k]] != comp[u]) indeg[comp[G->dest[k]]]++;
+
+    int head = 0, tail = 0;
+    for (int c = 0; c < ncomp; ++c)
+        if (indeg[c] == 0) order[tail++] = c;
+    while (head < tail) {
+        int c = order[head++];
+        for (int64_t i = start[c]; i < start[c + 1]; ++i) {
+            int u = members[i];
+            for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k) {
+                int d = comp[G->dest[k]];
+                if (d != c && --indeg[d] == 0) order[tail++] = d;
+            }
+        }
+    }
+
+    // Tarjan rend les puits d’abord : on parcourt l’ordre à l’envers
+    TarjanPartition P = partition_create_pooled(n);
+    for (int i = tail - 1; i >= 0; --i) {
+        int c = order[i];
+        char name[CLASS_NAME_SIZE];
+        snprintf(name, sizeof(name), "C%d", P.size + 1);
+        TarjanClass C = partition_new_class(&P, name, (int)(start[c + 1] - start[c]));
+        for (int64_t k = start[c]; k < start[c + 1]; ++k)
+            class_add_member(&C, members[k]);
+        partition_add_class(&P, C);
+    }
+
+    free(start);
+    free(members);
+    free(indeg);
+    free(order);
+    partition_finalize(&P, n);
+    return P;
+}
+
+
+// ============================================================================
+//  Point d’entrée
+// ============================================================================
+
+TarjanPartition scc_parallel(const CsrGraph *G, int nthreads) {
+    if (!G || G->n <= 0) return partition_create();
+    int n = G->n;
+
+    SccContext X;
+    X.G = G;
+    X.T = csr_transpose(G);
+    X.color = (atomic_int*)malloc(((size_t)n + 1) * sizeof(atomic_int));
+    X.comp = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    X.mark = (atomic_uchar*)malloc(((size_t)n + 1) * sizeof(atomic_uchar));
+    X.deg_in = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    X.deg_out = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    X.cursor = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+    if (!X.color || !X.comp || !X.mark || !X.deg_in || !X.deg_out || !X.cursor) {
+        perror("malloc scc context");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v <= n; ++v) {
+        atomic_init(&X.color[v], v == 0 ? -1 : 0);   // couleur 0 : tout le graphe
+        atomic_init(&X.mark[v], 0);
+        X.comp[v] = -1;
+    }
+    atomic_init(&X.next_comp, 0);
+    atomic_init(&X.next_color, 1);
+    atomic_init(&X.counter, 0);
+
+    pool_init(&X.pool, nthreads);
+    X.local = (IntStack*)malloc(X.pool.nthreads * sizeof(IntStack));
+    if (!X.local) {
+        perror("malloc scc buffers");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < X.pool.nthreads; ++c) X.local[c] = stack_create(64);
+
+    // 1a) élagage parallèle (quelques passes)
+    for (int round = 0; round < SCC_TRIM_ROUNDS; ++round) {
+        atomic_store(&X.counter, 0);
+        pool_parallel_for(&X.pool, n, trim_range, &X);
+        if (atomic_load(&X.counter) == 0) break;
+    }
+
+    // 1b) pivot puis BFS avant / arrière parallèles
+    int *best = (int*)malloc(X.pool.nthreads * sizeof(int));
+    if (!best) {
+        perror("malloc scc pivots");
+        exit(EXIT_FAILURE);
+    }
+    PivotArgs PA = { &X, best };
+    pool_parallel_for(&X.pool, n, pivot_range, &PA);
+    int pivot = -1;
+    int64_t pivot_score = -1;
+    for (int c = 0; c < X.pool.nthreads; ++c) {
+        int v = best[c];
+        if (v < 0) continue;
+        int64_t score = (G->row[v + 1] - G->row[v]) * (X.T.row[v + 1] - X.T.row[v]);
+        if (score > pivot_score) {
+            pivot_score = score;
+            pivot = v;
+        }
+    }
+    free(best);
+
+    if (pivot > 0) {
+        parallel_bfs(&X, G, pivot, MARK_FW);
+        parallel_bfs(&X, &X.T, pivot, MARK_BW);
+
+        // 1c) la SCC du pivot est FW ∩ BW, le reste part en tâches
+        int *alive = (int*)malloc(((size_t)n + 1) * sizeof(int));
+        if (!alive) {
+            perror("malloc scc alive");
+            exit(EXIT_FAILURE);
+        }
+        int nalive = 0;
+        for (int v = 1; v <= n; ++v)
+            if (get_color(&X, v) == 0) alive[nalive++] = v;
+
+        int *parts[3], counts[3];
+        split_by_marks(&X, alive, nalive, new_comp(&X), parts, counts);
+        free(alive);
+
+        // 2) tâches indépendantes sur le pool
+        dispatch_parts(&X, parts, counts, NULL, NULL);
+        pool_wait(&X.pool);
+    }
+
+    TarjanPartition P = build_partition(G, X.comp, atomic_load(&X.next_comp));
+
+    for (int c = 0; c < X.pool.nthreads; ++c) stack_free(&X.local[c]);
+    free(X.local);
+    pool_destroy(&X.pool);
+    csr_free(&X.T);
+    free((void*)X.color);
+    free(X.comp);
+    free((void*)X.mark);
+    free(X.deg_in);
+    free(X.deg_out);
+    free(X.cursor);
+    return P;
+}
+
+TarjanPartition scc_run(const CsrGraph *G, SccEngine engine, int nthreads) {
+    if (engine == SCC_PARALLEL)
+        return scc_parallel(G, nthreads);
+    return tarjan_run_csr(G);
+}
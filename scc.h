@@ -0,0 +1,28 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include "graph.h"
+#include "tarjan.h"
+
+// Moteur de calcul des composantes fortement connexes
+typedef enum {
+    SCC_TARJAN,    // Tarjan itératif, séquentiel (tarjan_run_csr)
+    SCC_PARALLEL   // forward-backward + élagage, multi-thread
+} SccEngine;
+
+// Calcule les SCC avec le moteur choisi.
+// nthreads <= 0 : un thread par cœur (ignoré par SCC_TARJAN).
+TarjanPartition scc_run(const CsrGraph *G, SccEngine engine, int nthreads);
+
+/*
+   Forward-backward parallèle :
+   1) élagage parallèle des sommets sans arc entrant ou sortant (SCC triviales)
+   2) BFS avant/arrière en parallèle depuis un pivot → la grosse SCC
+   3) les trois ensembles restants sont traités comme des tâches
+      indépendantes (élagage + forward-backward séquentiels) sur le pool.
+   Les classes sont rendues dans le même ordre que Tarjan
+   (ordre topologique inverse du graphe réduit), nommées C1, C2, ...
+*/
+TarjanPartition scc_parallel(const CsrGraph *G, int nthreads);
+
+#endif // SCC_H
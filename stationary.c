@@ -0,0 +1,295 @@
+#include "stationary.h"
+#include "threadpool.h"
+#include <math.h>
+#include <stdatomic.h>
+
+StationaryOptions stationary_default_options(void) {
+    StationaryOptions opt;
+    opt.tol = 1e-7;
+    opt.max_iter = 100000;
+    return opt;
+}
+
+StationaryReport stationary_solve_members(const CsrGraph *G, const int *members, int k,
+                                          const int *pos, const StationaryOptions *opt,
+                                          prob_t *pi_local) {
+    StationaryReport R = { 1, 0, 0, 0.0 };
+    if (k <= 0) return R;
+
+    // la classe est fermée si aucun arc ne sort de ses membres
+    for (int i = 0; i < k && R.closed; ++i) {
+        int u = members[i];
+        for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e) {
+            int v = G->dest[e];
+            if (pos[v] < 0 || pos[v] >= k || members[pos[v]] != v) {
+                R.closed = 0;
+                break;
+            }
+        }
+    }
+    if (!R.closed) {
+        for (int i = 0; i < k; ++i) pi_local[i] = 0;
+        return R;
+    }
+
+    // itérés en double : la somme reste exacte sur de longues itérations
+    double *x = (double*)malloc((size_t)k * sizeof(double));
+    double *y = (double*)malloc((size_t)k * sizeof(double));
+    if (!x || !y) {
+        perror("malloc stationary vectors");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < k; ++i) x[i] = 1.0 / k;   // départ uniforme
+
+    while (R.iterations < opt->max_iter) {
+        // y = x P (diffusion le long des arcs de chaque ligne)
+        for (int i = 0; i < k; ++i) y[i] = 0.0;
+        for (int i = 0; i < k; ++i) {
+            double xi = x[i];
+            if (xi == 0.0) continue;
+            int u = members[i];
+            for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+                y[pos[G->dest[e]]] += xi * G->prob[e];
+        }
+
+        // chaîne paresseuse puis renormalisation (les lignes du fichier
+        // ne somment à 1 qu’à 1% près)
+        double sum = 0.0;
+        for (int i = 0; i < k; ++i) {
+            y[i] = 0.5 * (x[i] + y[i]);
+            sum += y[i];
+        }
+        double diff = 0.0;
+        for (int i = 0; i < k; ++i) {
+            y[i] /= sum;
+            diff += fabs(y[i] - x[i]);
+        }
+
+        double *t = x; x = y; y = t;
+        R.iterations++;
+        R.residual = diff;
+        if (diff < opt->tol) {
+            R.converged = 1;
+            break;
+        }
+    }
+
+    for (int i = 0; i < k; ++i) pi_local[i] = (prob_t)x[i];
+    free(x);
+    free(y);
+    return R;
+}
+
+StationaryReport stationary_class(const CsrGraph *G, const TarjanPartition *P,
+                                  int class_index, const StationaryOptions *opt,
+                                  int *pos, prob_t *pi) {
+    StationaryReport R = { 0, 0, 0, 0.0 };
+    if (class_index < 0 || class_index >= P->size) return R;
+
+    StationaryOptions def = stationary_default_options();
+    if (!opt) opt = &def;
+
+    // seuls les membres de la classe sont touchés : O(taille de la classe),
+    // pas O(n), par appel
+    const TarjanClass *C = &P->classes[class_index];
+    prob_t *local = (prob_t*)malloc((C->size > 0 ? C->size : 1) * sizeof(prob_t));
+    if (!local) {
+        perror("malloc stationary class");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < C->size; ++i) pos[C->members[i]] = i;
+
+    R = stationary_solve_members(G, C->members, C->size, pos, opt, local);
+    for (int i = 0; i < C->size; ++i) {
+        pi[C->members[i]] = local[i];
+        pos[C->members[i]] = -1;   // pos revient à -1 pour l’appel suivant
+    }
+
+    free(local);
+    return R;
+}
+
+
+// ---------- Résolution de toutes les classes fermées en parallèle ----------
+typedef struct {
+    const CsrGraph          *G;
+    const TarjanPartition   *P;
+    const StationaryOptions *opt;
+    const int               *closed_list;   // indices des classes fermées
+    int                      nclosed;
+    const int               *pos;           // rang de chaque sommet dans sa classe
+    prob_t                  *pi;            // distribution de chaque classe (taille n+1)
+    StationaryReport        *reports;       // un bilan par classe fermée
+    atomic_int               next;          // prochaine classe à prendre
+} ClassJobs;
+
+// Chaque thread prend les classes une par une : une grosse classe n’en
+// bloque pas des milliers de petites derrière elle
+static void solve_classes(int64_t begin, int64_t end, int chunk, void *arg) {
+    (void)begin; (void)end; (void)chunk;
+    ClassJobs *J = (ClassJobs*)arg;
+    prob_t *local = NULL;
+    int cap = 0;
+
+    while (1) {
+        int i = atomic_fetch_add(&J->next, 1);
+        if (i >= J->nclosed) break;
+
+        const TarjanClass *C = &J->P->classes[J->closed_list[i]];
+        if (C->size > cap) {
+            cap = C->size;
+            prob_t *nl = (prob_t*)realloc(local, cap * sizeof(prob_t));
+            if (!nl) {
+                perror("realloc stationary block");
+                exit(EXIT_FAILURE);
+            }
+            local = nl;
+        }
+        J->reports[i] = stationary_solve_members(J->G, C->members, C->size, J->pos, J->opt, local);
+        for (int k = 0; k < C->size; ++k) J->pi[C->members[k]] = local[k];
+    }
+    free(local);
+}
+
+LimitReport stationary_limit(const CsrGraph *G, const TarjanPartition *P, const prob_t *init,
+                             const StationaryOptions *opt, int nthreads, prob_t *pi) {
+    LimitReport L = { 0, 0, 0, 0, 0.0 };
+    int n = G->n;
+    for (int v = 0; v <= n; ++v) pi[v] = 0;
+    if (n <= 0 || P->size == 0) return L;
+
+    StationaryOptions def = stationary_default_options();
+    if (!opt) opt = &def;
+
+    // classe de chaque sommet, rang dans la classe, classes fermées
+    int *v2c = build_vertex_to_class(P, n);
+    int *pos = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    char *closed = (char*)malloc(P->size);
+    int *closed_list = (int*)malloc(P->size * sizeof(int));
+    if (!pos || !closed || !closed_list) {
+        perror("malloc stationary limit");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < P->size; ++c) {
+        closed[c] = 1;
+        for (int k = 0; k < P->classes[c].size; ++k) pos[P->classes[c].members[k]] = k;
+    }
+    for (int u = 1; u <= n; ++u)
+        for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+            if (v2c[G->dest[e]] != v2c[u]) closed[v2c[u]] = 0;
+    for (int c = 0; c < P->size; ++c)
+        if (closed[c]) closed_list[L.closed_classes++] = c;
+
+    // 1) une distribution stationnaire par classe fermée, en parallèle
+    prob_t *pic = (prob_t*)calloc((size_t)n + 1, sizeof(prob_t));
+    StationaryReport *reports = (StationaryReport*)malloc(
+        (L.closed_classes > 0 ? L.closed_classes : 1) * sizeof(StationaryReport));
+    if (!pic || !reports) {
+        perror("malloc stationary limit");
+        exit(EXIT_FAILURE);
+    }
+    ClassJobs J;
+    J.G = G;
+    J.P = P;
+    J.opt = opt;
+    J.closed_list = closed_list;
+    J.nclosed = L.closed_classes;
+    J.pos = pos;
+    J.pi = pic;
+    J.reports = reports;
+    atomic_init(&J.next, 0);
+
+    ThreadPool pool;
+    pool_init(&pool, nthreads);
+    pool_parallel_for(&pool, pool.nthreads, solve_classes, &J);
+    pool_destroy(&pool);
+
+    for (int i = 0; i < L.closed_classes; ++i) {
+        if (reports[i].converged) L.converged_classes++;
+        if (reports[i].iterations > L.max_iterations) L.max_iterations = reports[i].iterations;
+    }
+
+    // 2) poids de chaque classe fermée : masse initiale qui y aboutit.
+    // Les transitoires sont rangés une fois, classe par classe, sources
+    // d’abord (P est rangée puits d’abord) : chaque classe ne reçoit de la
+    // masse que de classes déjà vidées et on ne pousse plus que la sienne,
+    // en une passe pour une classe réduite à un état. Si P n’est pas dans cet
+    // ordre, tous les transitoires forment un seul bloc.
+    double *w = (double*)calloc(P->size, sizeof(double));
+    double *x = (double*)calloc((size_t)n + 1, sizeof(double));
+    int *trans = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    int *start = (int*)malloc(((size_t)P->size + 1) * sizeof(int));
+    if (!w || !x || !trans || !start) {
+        perror("malloc stationary weights");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 1; v <= n; ++v) {
+        double m = init ? init[v] : 1.0 / n;
+        if (closed[v2c[v]]) w[v2c[v]] += m;
+        else x[v] = m;
+    }
+
+    int nblocks = 0, count = 0, ordered = 1;
+    for (int c = P->size - 1; c >= 0; --c) {
+        if (closed[c]) continue;
+        start[nblocks++] = count;
+        for (int k = 0; k < P->classes[c].size; ++k) {
+            int u = P->classes[c].members[k];
+            trans[count++] = u;
+            for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+                if (v2c[G->dest[e]] > c) ordered = 0;
+        }
+    }
+    start[nblocks] = count;
+    if (!ordered && nblocks > 1) {
+        start[1] = count;
+        nblocks = 1;
+    }
+
+    for (int b = 0; b < nblocks; ++b) {
+        double pending;
+        int sweeps = 0;
+        do {
+            for (int s = start[b]; s < start[b + 1]; ++s) {
+                int u = trans[s];
+                double m = x[u];
+                if (m == 0.0) continue;
+                x[u] = 0.0;
+                // une boucle u -> u renvoie la masse sur u : elle finit par
+                // repartir sur les autres arcs, au prorata de leurs poids
+                double out = 0.0;
+                for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e)
+                    if (G->dest[e] != u) out += G->prob[e];
+                if (out <= 0.0) continue;   // pas d’arc sortant : la masse est perdue
+                for (int64_t e = G->row[u]; e < G->row[u + 1]; ++e) {
+                    int v = G->dest[e];
+                    if (v == u) continue;
+                    double f = m * G->prob[e] / out;
+                    if (closed[v2c[v]]) w[v2c[v]] += f;
+                    else x[v] += f;
+                }
+            }
+            pending = 0.0;
+            for (int s = start[b]; s < start[b + 1]; ++s) pending += x[trans[s]];
+            sweeps++;
+        } while (pending > opt->tol && sweeps < opt->max_iter);
+        L.transient_steps += sweeps;
+    }
+    for (int s = 0; s < count; ++s) L.leftover += x[trans[s]];
+
+    // 3) assemblage
+    for (int v = 1; v <= n; ++v)
+        if (closed[v2c[v]]) pi[v] = (prob_t)(w[v2c[v]] * pic[v]);
+
+    free(w);
+    free(x);
+    free(trans);
+    free(start);
+    free(pic);
+    free(reports);
+    free(closed_list);
+    free(closed);
+    free(pos);
+    free(v2c);
+    return L;
+}
@@ -0,0 +1,70 @@
+#ifndef STATIONARY_H
+#define STATIONARY_H
+
+#include "graph.h"
+#include "tarjan.h"
+
+// Paramètres de l’itération de puissance creuse
+typedef struct {
+    double tol;        // arrêt quand ||pi(t+1) - pi(t)||_1 < tol
+    int    max_iter;   // nombre maximal d’itérations
+} StationaryOptions;
+
+// Bilan d’un calcul
+typedef struct {
+    int    closed;     // 1 si la classe est fermée (persistante)
+    int    converged;  // 1 si la tolérance a été atteinte
+    int    iterations; // itérations effectuées
+    double residual;   // dernier écart L1 entre deux itérés
+} StationaryReport;
+
+// tol = 1e-7, max_iter = 100000
+StationaryOptions stationary_default_options(void);
+
+/*
+   Distribution stationnaire d’une classe fermée, par itération de puissance
+   sur les arcs CSR de la classe : O(arcs de la classe) par itération, aucune
+   matrice dense. On itère la chaîne paresseuse (I + P) / 2, qui a la même
+   distribution stationnaire mais converge aussi quand la classe est périodique.
+   pi (taille n+1, indexé par sommet) reçoit la distribution sur les membres
+   de la classe ; les autres entrées ne sont pas touchées. Si la classe
+   n’est pas fermée, closed = 0 et ses membres reçoivent 0.
+   pos (taille n+1, mis à -1 une fois par l’appelant) sert de tableau de
+   rangs et revient à -1 en sortie : on le réutilise d’une classe à
+   l’autre, et un appel coûte O(taille + arcs de la classe), pas O(n).
+*/
+StationaryReport stationary_class(const CsrGraph *G, const TarjanPartition *P,
+                                  int class_index, const StationaryOptions *opt,
+                                  int *pos, prob_t *pi);
+
+// Même itération sur les k sommets members[] d’une classe (version bas niveau
+// utilisée par les calculs par lots). pos[v] = rang de v dans members.
+// pi_local (taille k) reçoit la distribution dans l’ordre de members.
+StationaryReport stationary_solve_members(const CsrGraph *G, const int *members, int k,
+                                          const int *pos, const StationaryOptions *opt,
+                                          prob_t *pi_local);
+
+// Bilan du calcul de la distribution limite globale
+typedef struct {
+    int    closed_classes;    // classes fermées résolues
+    int    converged_classes; // dont celles qui ont atteint la tolérance
+    int    max_iterations;    // plus grand nombre d’itérations d’une classe
+    int    transient_steps;   // balayages de la masse transitoire, tous blocs confondus
+    double leftover;          // masse encore transitoire à la fin
+} LimitReport;
+
+/*
+   Distribution limite (au sens de Cesàro) depuis la loi initiale init
+   (taille n+1, uniforme si NULL) :
+   1) chaque classe fermée est résolue indépendamment sur un pool de
+      nthreads threads (<= 0 : un par cœur) ;
+   2) la masse initiale des états transitoires est poussée le long des arcs
+      jusqu’à être absorbée, ce qui donne le poids w_c de chaque classe ;
+      seuls les transitoires sont parcourus, classe par classe depuis les
+      sources, chaque classe jusqu’à ce que sa propre masse tombe sous tol ;
+   3) pi[v] = w_c * pi_c(v) pour v dans la classe fermée c, 0 si transitoire.
+*/
+LimitReport stationary_limit(const CsrGraph *G, const TarjanPartition *P, const prob_t *init,
+                             const StationaryOptions *opt, int nthreads, prob_t *pi);
+
+#endif // STATIONARY_H
@@ -1,16 +1,15 @@
 #include "tarjan.h"
 
 // ---------- TarjanVertex array ----------
-// Initialise le tableau des sommets internes utilisés par Tarjan
-TarjanVertex* tarjan_init_vertices(const AdjList *G) {
-    if (!G || G->n <= 0) return NULL;
+// Alloue et initialise n+1 sommets internes (indices 1..n)
+static TarjanVertex* tarjan_alloc_vertices(int n) {
     // on alloue n+1 pour indexer de 1..n (on ignore l'indice 0)
-    TarjanVertex *arr = (TarjanVertex*)malloc((G->n + 1) * sizeof(TarjanVertex));
+    TarjanVertex *arr = (TarjanVertex*)malloc(((size_t)n + 1) * sizeof(TarjanVertex));
     if (!arr) {
         perror("malloc TarjanVertex");
         exit(EXIT_FAILURE);
     }
-    for (int i = 0; i <= G->n; ++i) {
+    for (int i = 0; i <= n; ++i) {
         arr[i].id = i;
         arr[i].index = -1;     // non visité
         arr[i].lowlink = -1;   // valeur minimum atteignable
@@ -19,6 +18,12 @@ TarjanVertex* tarjan_init_vertices(const AdjList *G) {
     return arr;
 }
 
+// Initialise le tableau des sommets internes utilisés par Tarjan
+TarjanVertex* tarjan_init_vertices(const AdjList *G) {
+    if (!G || G->n <= 0) return NULL;
+    return tarjan_alloc_vertices(G->n);
+}
+
 // Libère le tableau des TarjanVertex
 void tarjan_free_vertices(TarjanVertex *arr) {
     free(arr);
@@ -103,19 +108,28 @@ TarjanClass class_create(const char *name) {
     C.capacity = 0;
     C.members = NULL;
     C.size = 0;
+    C.pooled = 0;
     return C;
 }
 
 // Agrandit l'espace pour stocker plus de membres
 static void class_grow(TarjanClass *C) {
     int newcap = (C->capacity < 4) ? 4 : (C->capacity * 2);
-    int *nm = (int*)realloc(C->members, newcap * sizeof(int));
+    int *nm;
+    if (C->pooled) {
+        // le tableau de l’arène ne peut pas grandir : copie sur le tas
+        nm = (int*)malloc(newcap * sizeof(int));
+        if (nm) memcpy(nm, C->members, C->size * sizeof(int));
+    } else {
+        nm = (int*)realloc(C->members, newcap * sizeof(int));
+    }
     if (!nm) {
         perror("realloc class members");
         exit(EXIT_FAILURE);
     }
     C->members = nm;
     C->capacity = newcap;
+    C->pooled = 0;
 }
 
 // Ajoute un sommet dans une classe
@@ -126,7 +140,7 @@ void class_add_member(TarjanClass *C, int vertex_id) {
 
 // Libère les membres d'une classe
 void class_free(TarjanClass *C) {
-    free(C->members);
+    if (!C->pooled) free(C->members);
     C->members = NULL;
     C->size = 0;
     C->capacity = 0;
@@ -150,9 +164,46 @@ TarjanPartition partition_create(void) {
     P.classes = NULL;
     P.size = 0;
     P.capacity = 0;
+    P.vertices = NULL;
+    P.nvertices = 0;
+    P.vcapacity = 0;
+    P.offset = NULL;
+    P.class_of = NULL;
+    P.n = 0;
+    return P;
+}
+
+// Partition dont tous les membres tiennent dans un tableau de members_hint sommets
+TarjanPartition partition_create_pooled(int members_hint) {
+    TarjanPartition P = partition_create();
+    P.vcapacity = members_hint > 0 ? members_hint : 0;
+    P.vertices = (int*)malloc(((size_t)P.vcapacity + 1) * sizeof(int));
+    if (!P.vertices) {
+        perror("malloc partition vertices");
+        exit(EXIT_FAILURE);
+    }
     return P;
 }
 
+// Classe vide avec la place pour size membres (tableau à plat de P, sinon tas)
+TarjanClass partition_new_class(TarjanPartition *P, const char *name, int size) {
+    TarjanClass C = class_create(name);
+    if (size <= 0) return C;
+    if (P->vertices && P->nvertices + size <= P->vcapacity) {
+        C.members = P->vertices + P->nvertices;
+        P->nvertices += size;
+        C.pooled = 1;
+    } else {
+        C.members = (int*)malloc((size_t)size * sizeof(int));
+        if (!C.members) {
+            perror("malloc class members");
+            exit(EXIT_FAILURE);
+        }
+    }
+    C.capacity = size;
+    return C;
+}
+
 // Agrandit la partition
 static void partition_grow(TarjanPartition *P) {
     int newcap = (P->capacity < 4) ? 4 : (P->capacity * 2);
@@ -171,37 +222,106 @@ void partition_add_class(TarjanPartition *P, TarjanClass cls) {
     P->classes[P->size++] = cls; // copie shallow
 }
 
+/*
+   Disposition à plat. Si les classes sont déjà rangées dans l’ordre dans
+   vertices (cas des constructeurs de partition), rien n’est recopié ;
+   sinon (classes créées sur le tas, ou agrandies) on reconstruit le tableau.
+*/
+void partition_finalize(TarjanPartition *P, int n) {
+    int total = 0, in_place = 1;
+    for (int c = 0; c < P->size; ++c) {
+        const TarjanClass *C = &P->classes[c];
+        if (C->size > 0 && (!C->pooled || C->members != P->vertices + total)) in_place = 0;
+        total += C->size;
+    }
+
+    if (!in_place) {
+        int *flat = (int*)malloc(((size_t)total + 1) * sizeof(int));
+        if (!flat) {
+            perror("malloc partition vertices");
+            exit(EXIT_FAILURE);
+        }
+        int pos = 0;
+        for (int c = 0; c < P->size; ++c) {
+            TarjanClass *C = &P->classes[c];
+            memcpy(flat + pos, C->members, (size_t)C->size * sizeof(int));
+            if (!C->pooled) free(C->members);
+            C->members = flat + pos;
+            C->capacity = C->size;
+            C->pooled = 1;
+            pos += C->size;
+        }
+        free(P->vertices);
+        P->vertices = flat;
+        P->vcapacity = total;
+    }
+    P->nvertices = total;
+
+    // offsets et classe de chaque sommet
+    free(P->offset);
+    free(P->class_of);
+    P->offset = (int*)malloc(((size_t)P->size + 1) * sizeof(int));
+    for (int v = 0; v < total; ++v)
+        if (P->vertices[v] > n) n = P->vertices[v];
+    P->class_of = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (!P->offset || !P->class_of) {
+        perror("malloc partition index");
+        exit(EXIT_FAILURE);
+    }
+    P->n = n;
+    P->offset[0] = 0;
+    for (int c = 0; c < P->size; ++c) P->offset[c + 1] = P->offset[c] + P->classes[c].size;
+    for (int v = 0; v <= n; ++v) P->class_of[v] = -1;
+    for (int c = 0; c < P->size; ++c)
+        for (int k = P->offset[c]; k < P->offset[c + 1]; ++k)
+            if (P->vertices[k] >= 0) P->class_of[P->vertices[k]] = c;
+}
+
 // Libère toutes les classes
 void partition_free(TarjanPartition *P) {
-    if (!P || !P->classes) {
-        P->size = P->capacity = 0;
-        return;
-    }
+    if (!P) return;
     for (int i = 0; i < P->size; ++i) {
         class_free(&P->classes[i]);
     }
     free(P->classes);
-    P->classes = NULL;
-    P->size = 0;
-    P->capacity = 0;
+    free(P->vertices);   // membres regroupés : un seul bloc
+    free(P->offset);
+    free(P->class_of);
+    *P = partition_create();
 }
 
-// Affiche toutes les classes
+// Affiche toutes les classes depuis classes[i] (members, size), toujours à
+// jour : offset/vertices sont périmés si la partition a changé depuis
+// partition_finalize
 void partition_print(const TarjanPartition *P) {
-    for (int i = 0; i < P->size; ++i) {
-        class_print(&P->classes[i]);
-    }
+    for (int i = 0; i < P->size; ++i) class_print(&P->classes[i]);
 }
 
 
 // ================== TARJAN (DFS) ==================
-// Fonction récursive principale : détecte les SCC
-static void tarjan_dfs(int u,
-                       const AdjList *G,
-                       TarjanVertex *V,
-                       IntStack *S,
-                       int *pIndex,
-                       TarjanPartition *P)
+// Dépile la composante de racine u et l’ajoute à la partition
+static void tarjan_pop_class(int u, TarjanVertex *V, IntStack *S, TarjanPartition *P)
+{
+    char name[CLASS_NAME_SIZE];
+    snprintf(name, sizeof(name), "C%d", P->size + 1);
+
+    // taille de la composante : sommets empilés au-dessus de u (inclus)
+    int size = 1;
+    while (S->data[S->top - size] != u) size++;
+    TarjanClass C = partition_new_class(P, name, size);
+
+    // dépile jusqu’à u
+    while (!stack_empty(S)) {
+        int w = stack_pop(S);
+        V[w].on_stack = 0;
+        class_add_member(&C, w);
+        if (w == u) break;
+    }
+    partition_add_class(P, C);
+}
+
+// Numérote u et l’empile (entrée dans le sommet)
+static inline void tarjan_enter(int u, TarjanVertex *V, IntStack *S, int *pIndex)
 {
     V[u].index   = *pIndex;   // index d’entrée
     V[u].lowlink = *pIndex;   // valeur lowlink initiale
@@ -209,56 +329,158 @@ static void tarjan_dfs(int u,
 
     stack_push(S, u);
     V[u].on_stack = 1;
+}
 
-    // Parcourt les voisins de u
-    for (Cell *e = G->arr[u].head; e != NULL; e = e->next) {
-        int v = e->dest;
-        if (V[v].index == -1) {
-            // non visité → exploration
-            tarjan_dfs(v, G, V, S, pIndex, P);
-            if (V[v].lowlink < V[u].lowlink) V[u].lowlink = V[v].lowlink;
-        } else if (V[v].on_stack) {
-            // arête vers un sommet dans la pile → mise à jour lowlink
-            if (V[v].index < V[u].lowlink) V[u].lowlink = V[v].index;
-        }
-    }
-
+// Sortie de u : crée sa composante s’il est racine, puis remonte son
+// lowlink au parent (sommet qui se trouve maintenant en haut de la pile d’appel)
+static inline void tarjan_leave(int u, TarjanVertex *V, IntStack *S,
+                                const IntStack *calls, TarjanPartition *P)
+{
     // u est racine → créer une nouvelle composante
     if (V[u].lowlink == V[u].index) {
-        char name[8];
-        snprintf(name, sizeof(name), "C%d", P->size + 1);
-        TarjanClass C = class_create(name);
-
-        // dépile jusqu’à u
-        while (!stack_empty(S)) {
-            int w = stack_pop(S);
-            V[w].on_stack = 0;
-            class_add_member(&C, w);
-            if (w == u) break;
+        tarjan_pop_class(u, V, S, P);
+    }
+    if (!stack_empty(calls)) {
+        int parent = stack_peek(calls);
+        if (V[u].lowlink < V[parent].lowlink) V[parent].lowlink = V[u].lowlink;
+    }
+}
+
+/*
+   DFS itératif : la pile d’appel est une IntStack de sommets et la position
+   dans la liste de chaque sommet est gardée dans cur[u]. La mémoire reste
+   bornée (au plus n sommets empilés) quelle que soit la profondeur du DFS.
+*/
+static void tarjan_dfs(int root,
+                       const AdjList *G,
+                       TarjanVertex *V,
+                       IntStack *S,
+                       IntStack *calls,
+                       const Cell **cur,
+                       int *pIndex,
+                       TarjanPartition *P)
+{
+    tarjan_enter(root, V, S, pIndex);
+    cur[root] = G->arr[root].head;
+    stack_push(calls, root);
+
+    while (!stack_empty(calls)) {
+        int u = stack_peek(calls);
+
+        if (cur[u] != NULL) {
+            // voisin suivant de u
+            int v = cur[u]->dest;
+            cur[u] = cur[u]->next;
+
+            if (V[v].index == -1) {
+                // non visité → exploration
+                tarjan_enter(v, V, S, pIndex);
+                cur[v] = G->arr[v].head;
+                stack_push(calls, v);
+            } else if (V[v].on_stack) {
+                // arête vers un sommet dans la pile → mise à jour lowlink
+                if (V[v].index < V[u].lowlink) V[u].lowlink = V[v].index;
+            }
+        } else {
+            // tous les voisins de u sont traités
+            stack_pop(calls);
+            tarjan_leave(u, V, S, calls, P);
         }
-        partition_add_class(P, C);
     }
 }
 
 // Lance l’algorithme de Tarjan sur tout le graphe
 TarjanPartition tarjan_run(const AdjList *G)
 {
-    TarjanPartition P = partition_create();
-    if (!G || G->n <= 0) return P;
+    if (!G || G->n <= 0) return partition_create();
+    TarjanPartition P = partition_create_pooled(G->n);   // membres : un seul bloc
 
     TarjanVertex *V = tarjan_init_vertices(G);
     IntStack S = stack_create(G->n);
+    IntStack calls = stack_create(64);
+    const Cell **cur = (const Cell**)malloc((G->n + 1) * sizeof(Cell*));
+    if (!cur) {
+        perror("malloc tarjan cursors");
+        exit(EXIT_FAILURE);
+    }
 
     int index = 0;
     for (int u = 1; u <= G->n; ++u) {
         if (V[u].index == -1) {
-            tarjan_dfs(u, G, V, &S, &index, &P);
+            tarjan_dfs(u, G, V, &S, &calls, cur, &index, &P);
         }
     }
 
     // Nettoyage
+    free(cur);
+    stack_free(&calls);
+    stack_free(&S);
+    tarjan_free_vertices(V);
+    partition_finalize(&P, G->n);
+    return P;
+}
+
+// Même DFS itératif, la position courante est un indice d’arc CSR
+static void tarjan_dfs_csr(int root,
+                           const CsrGraph *G,
+                           TarjanVertex *V,
+                           IntStack *S,
+                           IntStack *calls,
+                           int64_t *cur,
+                           int *pIndex,
+                           TarjanPartition *P)
+{
+    tarjan_enter(root, V, S, pIndex);
+    cur[root] = G->row[root];
+    stack_push(calls, root);
+
+    while (!stack_empty(calls)) {
+        int u = stack_peek(calls);
+
+        if (cur[u] < G->row[u + 1]) {
+            int v = G->dest[cur[u]++];
+
+            if (V[v].index == -1) {
+                tarjan_enter(v, V, S, pIndex);
+                cur[v] = G->row[v];
+                stack_push(calls, v);
+            } else if (V[v].on_stack) {
+                if (V[v].index < V[u].lowlink) V[u].lowlink = V[v].index;
+            }
+        } else {
+            stack_pop(calls);
+            tarjan_leave(u, V, S, calls, P);
+        }
+    }
+}
+
+// Lance l’algorithme de Tarjan sur un graphe CSR
+TarjanPartition tarjan_run_csr(const CsrGraph *G)
+{
+    if (!G || G->n <= 0) return partition_create();
+    TarjanPartition P = partition_create_pooled(G->n);   // membres : un seul bloc
+
+    TarjanVertex *V = tarjan_alloc_vertices(G->n);
+    IntStack S = stack_create(G->n);
+    IntStack calls = stack_create(64);
+    int64_t *cur = (int64_t*)malloc(((size_t)G->n + 1) * sizeof(int64_t));
+    if (!cur) {
+        perror("malloc tarjan cursors");
+        exit(EXIT_FAILURE);
+    }
+
+    int index = 0;
+    for (int u = 1; u <= G->n; ++u) {
+        if (V[u].index == -1) {
+            tarjan_dfs_csr(u, G, V, &S, &calls, cur, &index, &P);
+        }
+    }
+
+    free(cur);
+    stack_free(&calls);
     stack_free(&S);
     tarjan_free_vertices(V);
+    partition_finalize(&P, G->n);
     return P;
 }
 
@@ -267,18 +489,70 @@ TarjanPartition tarjan_run(const AdjList *G)
 //  HASSE - Construction des liens entre classes
 // ============================================================================
 
-// Vérifie si un lien existe déjà
-static int link_exists(const t_link_array *L, int from, int to) {
-    for (int i = 0; i < L->size; ++i) {
-        if (L->data[i].from == from && L->data[i].to == to) return 1;
+// Ensemble des liens déjà vus : table de hachage à adressage ouvert sur la
+// clé (from << 32 | to), sondage linéaire, agrandie au-delà de 50% de remplissage
+#define LINK_EMPTY UINT64_MAX
+
+typedef struct {
+    uint64_t *keys;
+    size_t    mask;   // capacité - 1 (capacité puissance de 2)
+    size_t    size;
+} LinkSet;
+
+static LinkSet linkset_create(size_t expected) {
+    LinkSet S;
+    size_t cap = 16;
+    while (cap < 2 * expected) cap *= 2;
+    S.keys = (uint64_t*)malloc(cap * sizeof(uint64_t));
+    if (!S.keys) { perror("malloc link set"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < cap; ++i) S.keys[i] = LINK_EMPTY;
+    S.mask = cap - 1;
+    S.size = 0;
+    return S;
+}
+
+static void linkset_free(LinkSet *S) {
+    free(S->keys);
+    S->keys = NULL;
+    S->mask = 0;
+    S->size = 0;
+}
+
+static size_t link_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+// Ajoute la clé ; renvoie 1 si elle était absente
+static int linkset_insert(LinkSet *S, uint64_t key) {
+    if (2 * (S->size + 1) > S->mask + 1) {
+        LinkSet T = linkset_create(S->size + 1);
+        for (size_t i = 0; i <= S->mask; ++i)
+            if (S->keys[i] != LINK_EMPTY) linkset_insert(&T, S->keys[i]);
+        linkset_free(S);
+        *S = T;
+    }
+    size_t i = link_hash(key) & S->mask;
+    while (S->keys[i] != LINK_EMPTY) {
+        if (S->keys[i] == key) return 0;
+        i = (i + 1) & S->mask;
     }
-    return 0;
+    S->keys[i] = key;
+    S->size++;
+    return 1;
 }
 
 // map[v] = classe à laquelle appartient v
 int* build_vertex_to_class(const TarjanPartition *P, int n) {
     int *map = malloc((n + 1) * sizeof(int));
     if (!map) { perror("malloc map vertex->class"); exit(EXIT_FAILURE); }
+    if (P->class_of && P->n >= n) {
+        // déjà calculé par partition_finalize
+        memcpy(map, P->class_of, ((size_t)n + 1) * sizeof(int));
+        return map;
+    }
     for (int i = 0; i <= n; ++i) map[i] = -1;
 
     for (int ci = 0; ci < P->size; ++ci) {
@@ -291,6 +565,17 @@ int* build_vertex_to_class(const TarjanPartition *P, int n) {
     return map;
 }
 
+// Classe de chaque sommet 0..n : la table de la partition finalisée,
+// sinon une table calculée (rendue dans *owned, à libérer)
+static const int *vertex_classes(const TarjanPartition *P, int n, int **owned) {
+    if (P->class_of && P->n >= n) {
+        *owned = NULL;
+        return P->class_of;
+    }
+    *owned = build_vertex_to_class(P, n);
+    return *owned;
+}
+
 // Ajoute un lien from→to dans le tableau dynamique
 static void push_link(t_link_array *L, int a, int b) {
     if (L->size >= L->capacity) {
@@ -304,27 +589,57 @@ static void push_link(t_link_array *L, int a, int b) {
     L->size++;
 }
 
+// Ajoute le lien ci→cj s'il n'a pas encore été vu (ordre de première apparition)
+static void add_class_link(LinkSet *seen, t_link_array *L, int ci, int cj) {
+    uint64_t key = ((uint64_t)(uint32_t)ci << 32) | (uint32_t)cj;
+    if (linkset_insert(seen, key)) push_link(L, ci, cj);
+}
+
 // Crée tous les liens entre classes (pour le Hasse)
 void build_class_links(const AdjList *G, const TarjanPartition *P, t_link_array *links) {
     links->data = NULL;
     links->size = 0;
     links->capacity = 0;
 
-    int *v2c = build_vertex_to_class(P, G->n);
+    int *owned = NULL;
+    const int *v2c = vertex_classes(P, G->n, &owned);
+    LinkSet seen = linkset_create(P->size);
 
     for (int u = 1; u <= G->n; ++u) {
         int ci = v2c[u];
         for (Cell *e = G->arr[u].head; e != NULL; e = e->next) {
             int v = e->dest;
             int cj = v2c[v];
-            if (ci != cj && ci >= 0 && cj >= 0) {
-                if (!link_exists(links, ci, cj))
-                    push_link(links, ci, cj);
-            }
+            if (ci != cj && ci >= 0 && cj >= 0)
+                add_class_link(&seen, links, ci, cj);
+        }
+    }
+
+    linkset_free(&seen);
+    free(owned);
+}
+
+// Même construction que build_class_links, à partir du graphe CSR
+void build_class_links_csr(const CsrGraph *G, const TarjanPartition *P, t_link_array *links) {
+    links->data = NULL;
+    links->size = 0;
+    links->capacity = 0;
+
+    int *owned = NULL;
+    const int *v2c = vertex_classes(P, G->n, &owned);
+    LinkSet seen = linkset_create(P->size);
+
+    for (int u = 1; u <= G->n; ++u) {
+        int ci = v2c[u];
+        for (int64_t k = G->row[u]; k < G->row[u + 1]; ++k) {
+            int cj = v2c[G->dest[k]];
+            if (ci != cj && ci >= 0 && cj >= 0)
+                add_class_link(&seen, links, ci, cj);
         }
     }
 
-    free(v2c);
+    linkset_free(&seen);
+    free(owned);
 }
 
 // Affiche les liens Cx -> Cy
@@ -39,11 +39,15 @@ void     stack_free(IntStack *S);
 
 
 // ---------- 3) Classe (composante fortement connexe) ----------
+// Place pour "C" suivi de n'importe quel int (signe compris) et du '\0'
+#define CLASS_NAME_SIZE 16
+
 typedef struct {
-    char name[8];  // "C1", "C2", ...
+    char name[CLASS_NAME_SIZE]; // "C1", "C2", ...
     int  *members; // tableau dynamique d'identifiants de sommets
     int   size;
     int   capacity;
+    int   pooled;  // 1 : members pointe dans le tableau à plat de la partition
 } TarjanClass;
 
 TarjanClass class_create(const char *name);
@@ -53,13 +57,33 @@ void        class_print(const TarjanClass *C);
 
 
 // ---------- 4) Partition = ensemble de classes ----------
+// Disposition à plat (après partition_finalize) : les membres de toutes les
+// classes se suivent dans vertices, la classe c occupe
+// vertices[offset[c] .. offset[c+1]-1] et classes[c].members pointe dessus ;
+// class_of[v] donne la classe du sommet v (-1 s'il n'est dans aucune).
 typedef struct {
     TarjanClass *classes; // tableau dynamique de classes
     int size;
     int capacity;
+    int *vertices;        // membres, classe après classe (vcapacity places)
+    int  nvertices;       // places déjà attribuées
+    int  vcapacity;
+    int *offset;          // size+1 débuts de classe (NULL avant finalize)
+    int *class_of;        // n+1 entrées (NULL avant finalize)
+    int  n;               // plus grand sommet couvert par class_of
 } TarjanPartition;
 
 TarjanPartition partition_create(void);
+// Partition qui réserve un tableau à plat de members_hint sommets
+// (nombre total de membres attendu, ex. n) pour ses classes
+TarjanPartition partition_create_pooled(int members_hint);
+// Nouvelle classe avec de la place pour `size` membres, prise dans le
+// tableau à plat de P s'il reste de la place (sinon sur le tas)
+TarjanClass     partition_new_class(TarjanPartition *P, const char *name, int size);
+// Range toutes les classes dans le tableau à plat (recopie si besoin) et
+// calcule offset et class_of pour les sommets 1..n. À rappeler après
+// toute modification des classes.
+void            partition_finalize(TarjanPartition *P, int n);
 void            partition_add_class(TarjanPartition *P, TarjanClass cls);
 void            partition_free(TarjanPartition *P);
 void            partition_print(const TarjanPartition *P);
@@ -67,15 +91,20 @@ void            partition_print(const TarjanPartition *P);
 // ---- Algorithme de Tarjan : renvoie la partition (SCC) ----
 TarjanPartition tarjan_run(const AdjList *G);
 
-TarjanPartition tarjan_run(const AdjList *G);
+// ---- Même algorithme sur le graphe CSR (arcs contigus en mémoire) ----
+TarjanPartition tarjan_run_csr(const CsrGraph *G);
 
 // ======================= Hasse (diagramme entre classes) =======================
 
 // Associe chaque sommet à la classe à laquelle il appartient
+// (copie de class_of si la partition est finalisée ; à libérer)
 int* build_vertex_to_class(const TarjanPartition *P, int n);
 
-// Crée la liste des liens entre classes à partir du graphe et de la partition
+// Crée la liste des liens entre classes à partir du graphe et de la partition.
+// Chaque lien apparaît une fois, dans l'ordre de première rencontre ; les
+// doublons sont filtrés par une table de hachage (O(arcs) en moyenne).
 void build_class_links(const AdjList *G, const TarjanPartition *P, t_link_array *links);
+void build_class_links_csr(const CsrGraph *G, const TarjanPartition *P, t_link_array *links);
 
 // Affiche les liens (debug)
 void print_class_links(const t_link_array *links);
@@ -0,0 +1,147 @@
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+int pool_default_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int n = (int)info.dwNumberOfProcessors;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (n > 0) ? n : 1;
+}
+
+// Boucle d’un thread : prend les tâches dans la file jusqu’à l’arrêt
+static void *pool_worker(void *arg) {
+    ThreadPool *TP = (ThreadPool*)arg;
+
+    pthread_mutex_lock(&TP->lock);
+    while (1) {
+        while (!TP->head && !TP->stop)
+            pthread_cond_wait(&TP->has_job, &TP->lock);
+        if (!TP->head && TP->stop) break;
+
+        PoolJob *job = TP->head;
+        TP->head = job->next;
+        if (!TP->head) TP->tail = NULL;
+        pthread_mutex_unlock(&TP->lock);
+
+        job->fn(job->arg);
+        free(job);
+
+        pthread_mutex_lock(&TP->lock);
+        if (--TP->pending == 0)
+            pthread_cond_broadcast(&TP->idle);
+    }
+    pthread_mutex_unlock(&TP->lock);
+    return NULL;
+}
+
+void pool_init(ThreadPool *TP, int nthreads) {
+    if (nthreads <= 0) nthreads = pool_default_threads();
+
+    TP->nthreads = nthreads;
+    TP->head = TP->tail = NULL;
+    TP->pending = 0;
+    TP->stop = 0;
+    pthread_mutex_init(&TP->lock, NULL);
+    pthread_cond_init(&TP->has_job, NULL);
+    pthread_cond_init(&TP->idle, NULL);
+
+    TP->threads = (pthread_t*)malloc(nthreads * sizeof(pthread_t));
+    if (!TP->threads) {
+        perror("malloc pool threads");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < nthreads; ++t) {
+        if (pthread_create(&TP->threads[t], NULL, pool_worker, TP) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void pool_submit(ThreadPool *TP, PoolTask fn, void *arg) {
+    PoolJob *job = (PoolJob*)malloc(sizeof(PoolJob));
+    if (!job) {
+        perror("malloc pool job");
+        exit(EXIT_FAILURE);
+    }
+    job->fn = fn;
+    job->arg = arg;
+    job->next = NULL;
+
+    pthread_mutex_lock(&TP->lock);
+    if (TP->tail) TP->tail->next = job;
+    else TP->head = job;
+    TP->tail = job;
+    TP->pending++;
+    pthread_cond_signal(&TP->has_job);
+    pthread_mutex_unlock(&TP->lock);
+}
+
+void pool_wait(ThreadPool *TP) {
+    pthread_mutex_lock(&TP->lock);
+    while (TP->pending > 0)
+        pthread_cond_wait(&TP->idle, &TP->lock);
+    pthread_mutex_unlock(&TP->lock);
+}
+
+void pool_destroy(ThreadPool *TP) {
+    pthread_mutex_lock(&TP->lock);
+    TP->stop = 1;
+    pthread_cond_broadcast(&TP->has_job);
+    pthread_mutex_unlock(&TP->lock);
+
+    for (int t = 0; t < TP->nthreads; ++t)
+        pthread_join(TP->threads[t], NULL);
+
+    free(TP->threads);
+    TP->threads = NULL;
+    TP->nthreads = 0;
+    pthread_mutex_destroy(&TP->lock);
+    pthread_cond_destroy(&TP->has_job);
+    pthread_cond_destroy(&TP->idle);
+}
+
+
+// ---------- Boucle parallèle ----------
+typedef struct {
+    PoolRange body;
+    void     *arg;
+    int64_t   begin;
+    int64_t   end;
+    int       chunk;
+} RangeJob;
+
+static void range_job_run(void *arg) {
+    RangeJob *R = (RangeJob*)arg;
+    R->body(R->begin, R->end, R->chunk, R->arg);
+}
+
+void pool_parallel_for(ThreadPool *TP, int64_t n, PoolRange body, void *arg) {
+    int k = TP->nthreads;
+    RangeJob *jobs = (RangeJob*)malloc(k * sizeof(RangeJob));
+    if (!jobs) {
+        perror("malloc range jobs");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < k; ++c) {
+        jobs[c].body = body;
+        jobs[c].arg = arg;
+        jobs[c].begin = n * c / k;
+        jobs[c].end = n * (c + 1) / k;
+        jobs[c].chunk = c;
+        pool_submit(TP, range_job_run, &jobs[c]);
+    }
+    pool_wait(TP);
+    free(jobs);
+}
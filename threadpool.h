@@ -0,0 +1,51 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+// Tâche exécutée par un thread du pool
+typedef void (*PoolTask)(void *arg);
+
+// Maillon de la file d’attente des tâches
+typedef struct PoolJob {
+    PoolTask        fn;
+    void           *arg;
+    struct PoolJob *next;
+} PoolJob;
+
+// Pool de threads avec une file FIFO partagée
+typedef struct {
+    pthread_t      *threads;
+    int             nthreads;
+    PoolJob        *head;      // prochaine tâche à exécuter
+    PoolJob        *tail;
+    int             pending;   // tâches en file ou en cours d’exécution
+    int             stop;      // 1 : les threads doivent se terminer
+    pthread_mutex_t lock;
+    pthread_cond_t  has_job;   // signalé à chaque nouvelle tâche
+    pthread_cond_t  idle;      // signalé quand pending retombe à 0
+} ThreadPool;
+
+// Nombre de cœurs disponibles (au moins 1)
+int  pool_default_threads(void);
+
+// Démarre nthreads threads (nthreads <= 0 : un par cœur)
+void pool_init(ThreadPool *TP, int nthreads);
+
+// Ajoute une tâche ; peut être appelé depuis une tâche en cours
+void pool_submit(ThreadPool *TP, PoolTask fn, void *arg);
+
+// Attend que toutes les tâches (y compris celles ajoutées entre-temps) soient finies.
+// Ne doit pas être appelé depuis une tâche du pool.
+void pool_wait(ThreadPool *TP);
+
+// Arrête les threads et libère le pool
+void pool_destroy(ThreadPool *TP);
+
+// Découpe [0, n) en nthreads morceaux contigus et attend leur fin.
+// body(begin, end, chunk, arg) : chunk est l’indice du morceau (0..nthreads-1).
+typedef void (*PoolRange)(int64_t begin, int64_t end, int chunk, void *arg);
+void pool_parallel_for(ThreadPool *TP, int64_t n, PoolRange body, void *arg);
+
+#endif // THREADPOOL_H